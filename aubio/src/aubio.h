@@ -215,9 +215,12 @@ extern "C"
 #include "pitch/pitchyin.h"
 #include "pitch/pitchyinfft.h"
 #include "pitch/pitchyinfast.h"
+#include "pitch/pitchyinfastmulti.h"
 #include "pitch/pitchschmitt.h"
 #include "pitch/pitchfcomb.h"
 #include "pitch/pitchspecacf.h"
+#include "pitch/pitchmpm.h"
+#include "pitch/pitchbitacf.h"
 #include "tempo/beattracking.h"
 #include "utils/scale.h"
 #include "utils/hist.h"
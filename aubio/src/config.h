@@ -23,4 +23,10 @@
 #define HAVE_WAVWRITE 1
 #define HAVE_MEMCPY_HACKS 1
 
+// the vectorised fft only beats ooura where it has its sse2 / avx2 kernels
+#if (defined(__GNUC__) || defined(__clang__)) \
+  && (defined(__x86_64__) || defined(__i386__))
+#define HAVE_SIMD_FFT 1
+#endif
+
 #endif /* AUBIO_CONFIG_H */
@@ -20,6 +20,7 @@
 
 #include "aubio_priv.h"
 #include "fvec.h"
+#include "cvec.h"
 #include "pitch/pitch.h"
 #include "onset/onset.h"
 #include "notes/notes.h"
@@ -139,6 +140,14 @@ smpl_t aubio_notes_get_minioi_ms(const aubio_notes_t *o)
   return aubio_onset_get_minioi_ms(o->onset);
 }
 
+uint_t aubio_notes_get_delay(const aubio_notes_t *o)
+{
+  // the onset detection delay, then the note is only reported once the
+  // median of the pitch over the following hops is known
+  uint_t median_hops = o->median > 0 ? o->median - 1 : 0;
+  return aubio_onset_get_delay(o->onset) + median_hops * o->hop_size;
+}
+
 /** append new note candidate to the note_buffer and return filtered value. we
  * need to copy the input array as fvec_median destroy its input data.*/
 static void
@@ -220,6 +229,17 @@ void aubio_notes_do (aubio_notes_t *o, const fvec_t * input, fvec_t * notes)
   }
 }
 
+void aubio_notes_prime (aubio_notes_t *o)
+{
+  fvec_t *silence = new_fvec (o->hop_size);
+  // the note buffers are small, detecting a hop of silence with the pitch
+  // and onset objects touches the rest
+  aubio_pitch_prime (o->pitch);
+  aubio_onset_do (o->onset, silence, o->onset_output);
+  aubio_onset_reset (o->onset);
+  del_fvec (silence);
+}
+
 void del_aubio_notes (aubio_notes_t *o) {
   if (o->note_buffer) del_fvec(o->note_buffer);
   if (o->note_buffer2) del_fvec(o->note_buffer2);
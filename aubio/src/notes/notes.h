@@ -68,6 +68,15 @@ void del_aubio_notes(aubio_notes_t * o);
 */
 void aubio_notes_do (aubio_notes_t *o, const fvec_t * input, fvec_t * output);
 
+/** run the detection once on silence, before the first aubio_notes_do()
+
+  \param o note detection object as returned by new_aubio_notes()
+
+  See aubio_pitch_prime().
+
+*/
+void aubio_notes_prime (aubio_notes_t *o);
+
 /** set notes detection silence threshold
 
   \param o notes detection object as returned by new_aubio_notes()
@@ -96,6 +105,17 @@ smpl_t aubio_notes_get_silence(const aubio_notes_t * o);
  */
 smpl_t aubio_notes_get_minioi_ms(const aubio_notes_t *o);
 
+/** get notes detection delay, in samples
+
+  \param o notes detection object as returned by new_aubio_notes()
+
+  \return delay between the start of a note and the end of the frame
+  reporting it, the delay of the onset detection plus the hops taken to
+  compute the median of the pitch
+
+*/
+uint_t aubio_notes_get_delay(const aubio_notes_t *o);
+
 /** set notes detection minimum inter-onset interval, in millisecond
 
   \param o notes detection object as returned by new_aubio_notes()
@@ -30,6 +30,10 @@
 
 void aubio_onset_default_parameters (aubio_onset_t *o, const char_t * method);
 
+/* run onset detection on the spectral frame stored in o->fftgrain */
+static void aubio_onset_do_fftgrain (aubio_onset_t *o, const fvec_t * input,
+    fvec_t * onset);
+
 /** structure to store object state */
 struct _aubio_onset_t {
   aubio_pvoc_t * pv;            /**< phase vocoder */
@@ -55,8 +59,23 @@ struct _aubio_onset_t {
 /* execute onset detection function on iput buffer */
 void aubio_onset_do (aubio_onset_t *o, const fvec_t * input, fvec_t * onset)
 {
-  smpl_t isonset = 0;
   aubio_pvoc_do (o->pv,input, o->fftgrain);
+  aubio_onset_do_fftgrain (o, input, onset);
+}
+
+/* execute onset detection function on a spectral frame computed elsewhere */
+void aubio_onset_do_spectrum (aubio_onset_t *o, const fvec_t * input,
+    const cvec_t * fftgrain, fvec_t * onset)
+{
+  // whitening and compression modify the frame in place
+  cvec_copy (fftgrain, o->fftgrain);
+  aubio_onset_do_fftgrain (o, input, onset);
+}
+
+static void aubio_onset_do_fftgrain (aubio_onset_t *o, const fvec_t * input,
+    fvec_t * onset)
+{
+  smpl_t isonset = 0;
   /*
   if (apply_filtering) {
   }
@@ -227,9 +246,9 @@ smpl_t aubio_onset_get_thresholded_descriptor(const aubio_onset_t * o) {
   return thresholded->data[0];
 }
 
-/* Allocate memory for an onset detection */
-aubio_onset_t * new_aubio_onset (const char_t * onset_mode,
-    uint_t buf_size, uint_t hop_size, uint_t samplerate)
+/* Allocate memory for an onset detection, with or without phase vocoder */
+static aubio_onset_t * new_aubio_onset_with_pvoc (const char_t * onset_mode,
+    uint_t buf_size, uint_t hop_size, uint_t samplerate, uint_t with_pvoc)
 {
   aubio_onset_t * o = AUBIO_NEW(aubio_onset_t);
 
@@ -253,7 +272,9 @@ aubio_onset_t * new_aubio_onset (const char_t * onset_mode,
   o->hop_size = hop_size;
 
   /* allocate memory */
-  o->pv = new_aubio_pvoc(buf_size, o->hop_size);
+  if (with_pvoc) {
+    o->pv = new_aubio_pvoc(buf_size, o->hop_size);
+  }
   o->pp = new_aubio_peakpicker();
   o->od = new_aubio_specdesc(onset_mode,buf_size);
   if (o->od == NULL) goto beach_specdesc;
@@ -269,12 +290,26 @@ aubio_onset_t * new_aubio_onset (const char_t * onset_mode,
 
 beach_specdesc:
   del_aubio_peakpicker(o->pp);
-  del_aubio_pvoc(o->pv);
+  if (o->pv) del_aubio_pvoc(o->pv);
 beach:
   AUBIO_FREE(o);
   return NULL;
 }
 
+aubio_onset_t * new_aubio_onset (const char_t * onset_mode,
+    uint_t buf_size, uint_t hop_size, uint_t samplerate)
+{
+  return new_aubio_onset_with_pvoc (onset_mode, buf_size, hop_size,
+      samplerate, 1);
+}
+
+aubio_onset_t * new_aubio_onset_spectrum (const char_t * onset_mode,
+    uint_t buf_size, uint_t hop_size, uint_t samplerate)
+{
+  return new_aubio_onset_with_pvoc (onset_mode, buf_size, hop_size,
+      samplerate, 0);
+}
+
 void aubio_onset_reset (aubio_onset_t *o) {
   o->last_onset = 0;
   o->total_frames = 0;
@@ -340,7 +375,7 @@ void del_aubio_onset (aubio_onset_t *o)
   del_aubio_spectral_whitening(o->spectral_whitening);
   del_aubio_specdesc(o->od);
   del_aubio_peakpicker(o->pp);
-  del_aubio_pvoc(o->pv);
+  if (o->pv) del_aubio_pvoc(o->pv);
   del_fvec(o->desc);
   del_cvec(o->fftgrain);
   AUBIO_FREE(o);
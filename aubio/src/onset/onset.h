@@ -62,6 +62,21 @@ typedef struct _aubio_onset_t aubio_onset_t;
 aubio_onset_t * new_aubio_onset (const char_t * method,
     uint_t buf_size, uint_t hop_size, uint_t samplerate);
 
+/** create onset detection object without phase vocoder
+
+  \param method onset detection type as specified in specdesc.h
+  \param buf_size size of the spectral frames, `buf_size/2+1` bins
+  \param hop_size number of samples between two frames
+  \param samplerate sampling rate of the input signal
+
+  \return newly created ::aubio_onset_t, that only accepts spectral frames
+  computed elsewhere, with aubio_onset_do_spectrum(), and must not be passed
+  to aubio_onset_do()
+
+*/
+aubio_onset_t * new_aubio_onset_spectrum (const char_t * method,
+    uint_t buf_size, uint_t hop_size, uint_t samplerate);
+
 /** execute onset detection
 
   \param o onset detection object as returned by new_aubio_onset()
@@ -90,6 +105,26 @@ aubio_onset_t * new_aubio_onset (const char_t * method,
 */
 void aubio_onset_do (aubio_onset_t *o, const fvec_t * input, fvec_t * onset);
 
+/** execute onset detection on a spectral frame computed elsewhere
+
+  \param o onset detection object as returned by new_aubio_onset() or
+  new_aubio_onset_spectrum()
+  \param input new audio vector of length hop_size, used for the silence
+  threshold
+  \param fftgrain spectral frame of length `buf_size/2+1` describing the
+  last `buf_size` samples, used instead of the internal phase vocoder
+  \param onset output vector, as in aubio_onset_do()
+
+  This function can be used when a spectrum of the signal is already
+  available, for instance from aubio_pitch_get_spectrum(). The frame is
+  copied, and only the methods reading its norm (`energy`, `hfc`,
+  `specflux`, `specdiff`, `kl` and `mkl`) should be used when its phase is
+  not set.
+
+*/
+void aubio_onset_do_spectrum (aubio_onset_t *o, const fvec_t * input,
+    const cvec_t * fftgrain, fvec_t * onset);
+
 /** get the time of the latest onset detected, in samples
 
   \param o onset detection object as returned by new_aubio_onset()
@@ -34,6 +34,8 @@
 #include "pitch/pitchyinfft.h"
 #include "pitch/pitchyinfast.h"
 #include "pitch/pitchspecacf.h"
+#include "pitch/pitchmpm.h"
+#include "pitch/pitchbitacf.h"
 #include "pitch/pitch.h"
 
 #define DEFAULT_PITCH_SILENCE -50.
@@ -48,6 +50,8 @@ typedef enum
   aubio_pitcht_yinfft,     /**< `yinfft`, Spectral YIN */
   aubio_pitcht_yinfast,    /**< `yinfast`, YIN fast */
   aubio_pitcht_specacf,    /**< `specacf`, Spectral autocorrelation */
+  aubio_pitcht_mpm,        /**< `mpm`, McLeod Pitch Method */
+  aubio_pitcht_bitacf,     /**< `bitacf`, Bitstream autocorrelation */
   aubio_pitcht_default
     = aubio_pitcht_yinfft, /**< `default` */
 } aubio_pitch_type;
@@ -65,6 +69,9 @@ typedef enum
 /** callback to get pitch candidate, defined below */
 typedef void (*aubio_pitch_detect_t) (aubio_pitch_t * p, const fvec_t * ibuf, fvec_t * obuf);
 
+/** callback to slide the input of a silent window without detection */
+typedef void (*aubio_pitch_skip_t) (aubio_pitch_t * p, const fvec_t * ibuf);
+
 /** callback to convert pitch from one unit to another, defined below */
 typedef smpl_t(*aubio_pitch_convert_t) (smpl_t value, uint_t samplerate, uint_t bufsize);
 
@@ -78,16 +85,28 @@ struct _aubio_pitch_t
   aubio_pitch_mode mode;          /**< pitch detection output mode */
   uint_t samplerate;              /**< samplerate */
   uint_t bufsize;                 /**< buffer size */
+  uint_t hopsize;                 /**< hop size */
   void *p_object;                 /**< pointer to pitch object */
   aubio_filter_t *filter;         /**< filter */
   fvec_t *filtered;               /**< filtered input */
   aubio_pvoc_t *pv;               /**< phase vocoder for mcomb */
   cvec_t *fftgrain;               /**< spectral frame for mcomb */
-  fvec_t *buf;                    /**< temporary buffer for yin */
+  fvec_t buf;                     /**< last bufsize samples, a view in ring */
   aubio_pitch_detect_t detect_cb; /**< callback to get the pitch candidates */
+  aubio_pitch_skip_t skip_cb;     /**< callback to skip a silent window */
   aubio_pitch_convert_t conv_cb;  /**< callback to convert it to the desired unit */
   aubio_pitch_get_conf_t conf_cb; /**< pointer to the current confidence callback */
   smpl_t silence;                 /**< silence threshold */
+  smpl_t hysteresis;              /**< level above silence to leave it */
+  uint_t silent;                  /**< whether the last hop was silent */
+  uint_t skipped;                 /**< whether the last window was skipped */
+  fvec_t squares;                 /**< squares of buf, a view in squares_ring */
+  fvec_t *ring;                   /**< storage for buf, twice its length */
+  fvec_t *squares_ring;           /**< storage for squares, same layout */
+  uint_t ring_pos;                /**< position of buf and squares in rings */
+  smpl_t head_energy;             /**< sum of the first half of squares */
+  smpl_t hop_energy;              /**< sum of the squares of the last hop */
+  fvec_t tail;                    /**< where the next hop goes, a view in ring */
 };
 
 /* callback functions for pitch detection */
@@ -98,15 +117,33 @@ static void aubio_pitch_do_fcomb (aubio_pitch_t * p, const fvec_t * ibuf, fvec_t
 static void aubio_pitch_do_yinfft (aubio_pitch_t * p, const fvec_t * ibuf, fvec_t * obuf);
 static void aubio_pitch_do_yinfast (aubio_pitch_t * p, const fvec_t * ibuf, fvec_t * obuf);
 static void aubio_pitch_do_specacf (aubio_pitch_t * p, const fvec_t * ibuf, fvec_t * obuf);
+static void aubio_pitch_do_mpm (aubio_pitch_t * p, const fvec_t * ibuf, fvec_t * obuf);
+static void aubio_pitch_do_bitacf (aubio_pitch_t * p, const fvec_t * ibuf, fvec_t * obuf);
+
+/* callback functions for silent windows */
+static void aubio_pitch_skip_none (aubio_pitch_t * p, const fvec_t * ibuf);
+static void aubio_pitch_skip_yin (aubio_pitch_t * p, const fvec_t * ibuf);
+static void aubio_pitch_skip_yinfast (aubio_pitch_t * p, const fvec_t * ibuf);
 
 /* internal functions for frequency conversion */
 static smpl_t freqconvbin (smpl_t f, uint_t samplerate, uint_t bufsize);
 static smpl_t freqconvmidi (smpl_t f, uint_t samplerate, uint_t bufsize);
 static smpl_t freqconvpass (smpl_t f, uint_t samplerate, uint_t bufsize);
 
-/* adapter to stack ibuf new samples at the end of buf, and trim `buf` to `bufsize` */
+/* adapter to stack ibuf new samples at the end of buf, and trim `buf` to
+ * `bufsize`, along with their squares and the running energy */
 void aubio_pitch_slideblock (aubio_pitch_t * p, const fvec_t * ibuf);
 
+/* same, for hop samples already written where the slide puts them */
+static void aubio_pitch_slide (aubio_pitch_t * p, uint_t hop);
+
+/* position in ring of the hop samples appended by the next slide */
+static smpl_t *aubio_pitch_next_hop (aubio_pitch_t * p, uint_t hop);
+
+/* silence detection, then detection and conversion of the last window */
+static void aubio_pitch_detect (aubio_pitch_t * p, const fvec_t * ibuf,
+    fvec_t * obuf);
+
 
 aubio_pitch_t *
 new_aubio_pitch (const char_t * pitch_mode,
@@ -132,6 +169,10 @@ new_aubio_pitch (const char_t * pitch_mode,
     pitch_type = aubio_pitcht_fcomb;
   else if (strcmp (pitch_mode, "specacf") == 0)
     pitch_type = aubio_pitcht_specacf;
+  else if (strcmp (pitch_mode, "mpm") == 0)
+    pitch_type = aubio_pitcht_mpm;
+  else if (strcmp (pitch_mode, "bitacf") == 0)
+    pitch_type = aubio_pitcht_bitacf;
   else if (strcmp (pitch_mode, "default") == 0)
     pitch_type = aubio_pitcht_default;
   else {
@@ -158,16 +199,37 @@ new_aubio_pitch (const char_t * pitch_mode,
   p->type = pitch_type;
   aubio_pitch_set_unit (p, "default");
   p->bufsize = bufsize;
+  p->hopsize = hopsize;
   p->silence = DEFAULT_PITCH_SILENCE;
+  p->hysteresis = 0.;
+  p->silent = 0;
+  p->skipped = 0;
   p->conf_cb = NULL;
+  p->skip_cb = NULL;
+  p->ring = new_fvec (2 * bufsize);
+  p->squares_ring = new_fvec (2 * bufsize);
+  p->ring_pos = 0;
+  p->buf.data = p->ring->data;
+  p->buf.length = bufsize;
+  p->squares.data = p->squares_ring->data;
+  p->squares.length = bufsize;
+  p->head_energy = 0.;
+  p->hop_energy = 0.;
+  p->tail.data = aubio_pitch_next_hop (p, hopsize);
+  p->tail.length = hopsize;
   switch (p->type) {
     case aubio_pitcht_yin:
-      p->buf = new_fvec (bufsize);
       p->p_object = new_aubio_pitchyin (bufsize);
       if (!p->p_object) goto beach;
       p->detect_cb = aubio_pitch_do_yin;
+      p->skip_cb = aubio_pitch_skip_yin;
       p->conf_cb = (aubio_pitch_get_conf_t)aubio_pitchyin_get_confidence;
       aubio_pitchyin_set_tolerance (p->p_object, 0.15);
+      // the window slides by hopsize, only the newest samples need to be
+      // compared when the hop is a fraction of the lags searched
+      if (hopsize < bufsize / 2 && (bufsize / 2) % hopsize == 0) {
+        aubio_pitchyin_set_hop_size (p->p_object, hopsize);
+      }
       break;
     case aubio_pitcht_mcomb:
       p->filtered = new_fvec (hopsize);
@@ -179,40 +241,58 @@ new_aubio_pitch (const char_t * pitch_mode,
       p->detect_cb = aubio_pitch_do_mcomb;
       break;
     case aubio_pitcht_fcomb:
-      p->buf = new_fvec (bufsize);
       p->p_object = new_aubio_pitchfcomb (bufsize, hopsize);
       if (!p->p_object) goto beach;
       p->detect_cb = aubio_pitch_do_fcomb;
       break;
     case aubio_pitcht_schmitt:
-      p->buf = new_fvec (bufsize);
       p->p_object = new_aubio_pitchschmitt (bufsize);
       p->detect_cb = aubio_pitch_do_schmitt;
+      p->skip_cb = aubio_pitch_skip_none;
       break;
     case aubio_pitcht_yinfft:
-      p->buf = new_fvec (bufsize);
       p->p_object = new_aubio_pitchyinfft (samplerate, bufsize);
       if (!p->p_object) goto beach;
       p->detect_cb = aubio_pitch_do_yinfft;
+      p->skip_cb = aubio_pitch_skip_none;
       p->conf_cb = (aubio_pitch_get_conf_t)aubio_pitchyinfft_get_confidence;
       aubio_pitchyinfft_set_tolerance (p->p_object, 0.85);
       break;
     case aubio_pitcht_yinfast:
-      p->buf = new_fvec (bufsize);
       p->p_object = new_aubio_pitchyinfast (bufsize);
       if (!p->p_object) goto beach;
       p->detect_cb = aubio_pitch_do_yinfast;
+      p->skip_cb = aubio_pitch_skip_yinfast;
       p->conf_cb = (aubio_pitch_get_conf_t)aubio_pitchyinfast_get_confidence;
       aubio_pitchyinfast_set_tolerance (p->p_object, 0.15);
+      // the window slides by hopsize, only the newest samples need to be
+      // transformed
+      if ((bufsize / 2) % hopsize == 0) {
+        aubio_pitchyinfast_set_hop_size (p->p_object, hopsize);
+      }
       break;
     case aubio_pitcht_specacf:
-      p->buf = new_fvec (bufsize);
       p->p_object = new_aubio_pitchspecacf (bufsize);
       if (!p->p_object) goto beach;
       p->detect_cb = aubio_pitch_do_specacf;
+      p->skip_cb = aubio_pitch_skip_none;
       p->conf_cb = (aubio_pitch_get_conf_t)aubio_pitchspecacf_get_tolerance;
       aubio_pitchspecacf_set_tolerance (p->p_object, 0.85);
       break;
+    case aubio_pitcht_mpm:
+      p->p_object = new_aubio_pitchmpm (bufsize);
+      if (!p->p_object) goto beach;
+      p->detect_cb = aubio_pitch_do_mpm;
+      p->skip_cb = aubio_pitch_skip_none;
+      p->conf_cb = (aubio_pitch_get_conf_t)aubio_pitchmpm_get_confidence;
+      break;
+    case aubio_pitcht_bitacf:
+      p->p_object = new_aubio_pitchbitacf (bufsize);
+      if (!p->p_object) goto beach;
+      p->detect_cb = aubio_pitch_do_bitacf;
+      p->skip_cb = aubio_pitch_skip_none;
+      p->conf_cb = (aubio_pitch_get_conf_t)aubio_pitchbitacf_get_confidence;
+      break;
     default:
       break;
   }
@@ -220,7 +300,8 @@ new_aubio_pitch (const char_t * pitch_mode,
 
 beach:
   if (p->filtered) del_fvec(p->filtered);
-  if (p->buf) del_fvec(p->buf);
+  if (p->ring) del_fvec(p->ring);
+  if (p->squares_ring) del_fvec(p->squares_ring);
   AUBIO_FREE(p);
   return NULL;
 }
@@ -230,7 +311,6 @@ del_aubio_pitch (aubio_pitch_t * p)
 {
   switch (p->type) {
     case aubio_pitcht_yin:
-      del_fvec (p->buf);
       del_aubio_pitchyin (p->p_object);
       break;
     case aubio_pitcht_mcomb:
@@ -241,49 +321,97 @@ del_aubio_pitch (aubio_pitch_t * p)
       del_aubio_pitchmcomb (p->p_object);
       break;
     case aubio_pitcht_schmitt:
-      del_fvec (p->buf);
       del_aubio_pitchschmitt (p->p_object);
       break;
     case aubio_pitcht_fcomb:
-      del_fvec (p->buf);
       del_aubio_pitchfcomb (p->p_object);
       break;
     case aubio_pitcht_yinfft:
-      del_fvec (p->buf);
       del_aubio_pitchyinfft (p->p_object);
       break;
     case aubio_pitcht_yinfast:
-      del_fvec (p->buf);
       del_aubio_pitchyinfast (p->p_object);
       break;
     case aubio_pitcht_specacf:
-      del_fvec (p->buf);
       del_aubio_pitchspecacf (p->p_object);
       break;
+    case aubio_pitcht_mpm:
+      del_aubio_pitchmpm (p->p_object);
+      break;
+    case aubio_pitcht_bitacf:
+      del_aubio_pitchbitacf (p->p_object);
+      break;
     default:
       break;
   }
+  del_fvec (p->ring);
+  del_fvec (p->squares_ring);
   AUBIO_FREE (p);
 }
 
+smpl_t *
+aubio_pitch_next_hop (aubio_pitch_t * p, uint_t hop)
+{
+  uint_t length = p->buf.length;
+  uint_t pos = (p->ring_pos + hop > length) ? 0 : p->ring_pos + hop;
+  return p->ring->data + pos + length - hop;
+}
+
 void
 aubio_pitch_slideblock (aubio_pitch_t * p, const fvec_t * ibuf)
 {
-  uint_t overlap_size = p->buf->length - ibuf->length;
-#if 1 //!HAVE_MEMCPY_HACKS
+  smpl_t *next = aubio_pitch_next_hop (p, ibuf->length);
+  if (next != ibuf->data) {
+    memcpy (next, ibuf->data, ibuf->length * sizeof (smpl_t));
+  }
+  aubio_pitch_slide (p, ibuf->length);
+}
+
+void
+aubio_pitch_slide (aubio_pitch_t * p, uint_t hop)
+{
+  uint_t length = p->buf.length;
+  uint_t half = length / 2;
+  uint_t overlap_size = length - hop;
   uint_t j;
-  for (j = 0; j < overlap_size; j++) {
-    p->buf->data[j] = p->buf->data[j + ibuf->length];
+  fvec_t head;
+  // the first hop squares leave the first half, and the hop squares after
+  // them enter it
+  if (hop <= half) {
+    for (j = 0; j < hop; j++) {
+      p->head_energy += p->squares.data[half + j] - p->squares.data[j];
+    }
   }
-  for (j = 0; j < ibuf->length; j++) {
-    p->buf->data[j + overlap_size] = ibuf->data[j];
+  // slide the views forward in their rings, which are twice as long as the
+  // window, and copy the overlap back to the start of the rings when the
+  // end is reached, about once per window. the new samples, already at the
+  // end of the next window, only overwrite samples out of the window or in
+  // its first hop, which leaves it here
+  if (p->ring_pos + hop > length) {
+    for (j = 0; j < overlap_size; j++) {
+      p->ring->data[j] = p->buf.data[j + hop];
+      p->squares_ring->data[j] = p->squares.data[j + hop];
+    }
+    p->ring_pos = 0;
+  } else {
+    p->ring_pos += hop;
+  }
+  p->buf.data = p->ring->data + p->ring_pos;
+  p->squares.data = p->squares_ring->data + p->ring_pos;
+  // the squares of the new samples
+  p->hop_energy = 0.;
+  for (j = 0; j < hop; j++) {
+    p->squares.data[overlap_size + j] = SQR (p->buf.data[overlap_size + j]);
+    p->hop_energy += p->squares.data[overlap_size + j];
+  }
+  // sum again on each copy, so that rounding errors of the running sum do
+  // not accumulate
+  if (hop > half || p->ring_pos == 0) {
+    head.data = p->squares.data;
+    head.length = half;
+    p->head_energy = fvec_sum (&head);
   }
-#else
-  smpl_t *data = p->buf->data;
-  smpl_t *newdata = ibuf->data;
-  memmove(data, data + ibuf->length, overlap_size);
-  memcpy(data + overlap_size, newdata, ibuf->length);
-#endif
+  p->tail.data = aubio_pitch_next_hop (p, p->hopsize);
 }
 
 uint_t
@@ -349,6 +477,12 @@ aubio_pitch_set_tolerance (aubio_pitch_t * p, smpl_t tol)
     case aubio_pitcht_yinfast:
       aubio_pitchyinfast_set_tolerance (p->p_object, tol);
       break;
+    case aubio_pitcht_mpm:
+      aubio_pitchmpm_set_tolerance (p->p_object, tol);
+      break;
+    case aubio_pitcht_bitacf:
+      aubio_pitchbitacf_set_tolerance (p->p_object, tol);
+      break;
     default:
       break;
   }
@@ -369,6 +503,12 @@ aubio_pitch_get_tolerance (aubio_pitch_t * p)
     case aubio_pitcht_yinfast:
       tolerance = aubio_pitchyinfast_get_tolerance (p->p_object);
       break;
+    case aubio_pitcht_mpm:
+      tolerance = aubio_pitchmpm_get_tolerance (p->p_object);
+      break;
+    case aubio_pitcht_bitacf:
+      tolerance = aubio_pitchbitacf_get_tolerance (p->p_object);
+      break;
     default:
       break;
   }
@@ -393,18 +533,185 @@ aubio_pitch_get_silence (aubio_pitch_t * p)
   return p->silence;
 }
 
+uint_t
+aubio_pitch_set_silence_hysteresis (aubio_pitch_t * p, smpl_t hysteresis)
+{
+  if (hysteresis >= 0 && hysteresis <= 200) {
+    p->hysteresis = hysteresis;
+    return AUBIO_OK;
+  } else {
+    AUBIO_WRN("pitch: could not set silence hysteresis to %.2f\n", hysteresis);
+    return AUBIO_FAIL;
+  }
+}
+
+smpl_t
+aubio_pitch_get_silence_hysteresis (aubio_pitch_t * p)
+{
+  return p->hysteresis;
+}
+
+uint_t
+aubio_pitch_get_silent (aubio_pitch_t * p)
+{
+  return p->silent;
+}
+
+uint_t
+aubio_pitch_get_delay (aubio_pitch_t * p)
+{
+  switch (p->type) {
+    case aubio_pitcht_yin:
+    case aubio_pitcht_yinfast:
+      /* the difference function compares the first half of the window with
+       * its copy delayed by the period, so the estimate describes the samples
+       * from the start of the window to half a window plus the period. Its
+       * centre is given for a period of a quarter window, in the middle of
+       * the periods searched */
+      return p->bufsize - (p->bufsize / 2 + p->bufsize / 4) / 2;
+    default:
+      /* the other methods weigh the whole window alike, or symmetrically
+       * around its centre */
+      return p->bufsize / 2;
+  }
+}
+
+uint_t
+aubio_pitch_set_frequency_range (aubio_pitch_t * p, smpl_t min_freq,
+    smpl_t max_freq)
+{
+  uint_t tau_min, tau_max;
+  if (min_freq <= 0 || max_freq < min_freq) {
+    AUBIO_ERR ("pitch: invalid frequency range %.2f - %.2f Hz\n",
+        min_freq, max_freq);
+    return AUBIO_FAIL;
+  }
+  // the longest period is rounded up and the shortest down, so that both
+  // ends of the range can be found
+  tau_min = (uint_t)FLOOR (p->samplerate / max_freq);
+  tau_max = (uint_t)CEIL (p->samplerate / min_freq);
+  switch (p->type) {
+    case aubio_pitcht_yin:
+      return aubio_pitchyin_set_tau_range (p->p_object, tau_min, tau_max);
+    case aubio_pitcht_yinfft:
+      return aubio_pitchyinfft_set_tau_range (p->p_object, tau_min, tau_max);
+    case aubio_pitcht_yinfast:
+      return aubio_pitchyinfast_set_tau_range (p->p_object, tau_min, tau_max);
+    case aubio_pitcht_mpm:
+      return aubio_pitchmpm_set_tau_range (p->p_object, tau_min, tau_max);
+    case aubio_pitcht_bitacf:
+      return aubio_pitchbitacf_set_tau_range (p->p_object, tau_min, tau_max);
+    default:
+      return AUBIO_FAIL;
+  }
+}
+
+uint_t
+aubio_pitch_get_spectrum (aubio_pitch_t * p, cvec_t * spectrum)
+{
+  if (spectrum->length != p->bufsize / 2 + 1) {
+    AUBIO_ERR ("pitch: spectrum has length %d, expected %d\n",
+        spectrum->length, p->bufsize / 2 + 1);
+    return AUBIO_FAIL;
+  }
+  // when the last window was skipped as silent, no spectrum was computed
+  switch (p->type) {
+    case aubio_pitcht_yinfft:
+      if (!p->skipped)
+        aubio_pitchyinfft_get_spectrum (p->p_object, spectrum);
+      break;
+    case aubio_pitcht_yinfast:
+      if (!p->skipped)
+        aubio_pitchyinfast_get_spectrum (p->p_object, spectrum);
+      break;
+    case aubio_pitcht_specacf:
+      if (!p->skipped)
+        aubio_pitchspecacf_get_spectrum (p->p_object, spectrum);
+      break;
+    case aubio_pitcht_mcomb:
+      // the frame of the phase vocoder run before the comb
+      memcpy (spectrum->norm, p->fftgrain->norm,
+          spectrum->length * sizeof (smpl_t));
+      break;
+    case aubio_pitcht_fcomb:
+      aubio_pitchfcomb_get_spectrum (p->p_object, spectrum);
+      break;
+    default:
+      return AUBIO_FAIL;
+  }
+  if (p->skipped) {
+    cvec_norm_zeros (spectrum);
+  }
+  return AUBIO_OK;
+}
+
 
 /* do method, calling the detection callback, then the conversion callback */
 void
 aubio_pitch_do (aubio_pitch_t * p, const fvec_t * ibuf, fvec_t * obuf)
 {
-  p->detect_cb (p, ibuf, obuf);
-  if (aubio_silence_detection(ibuf, p->silence) == 1) {
+  aubio_pitch_slideblock (p, ibuf);
+  aubio_pitch_detect (p, ibuf, obuf);
+}
+
+fvec_t *
+aubio_pitch_get_tail (aubio_pitch_t * p)
+{
+  return &p->tail;
+}
+
+void
+aubio_pitch_do_tail (aubio_pitch_t * p, fvec_t * obuf)
+{
+  // the slide moves the view, not the samples written to it
+  fvec_t hop = p->tail;
+  aubio_pitch_slide (p, hop.length);
+  aubio_pitch_detect (p, &hop, obuf);
+}
+
+void
+aubio_pitch_detect (aubio_pitch_t * p, const fvec_t * ibuf, fvec_t * obuf)
+{
+  smpl_t level;
+  // same as aubio_db_spl (ibuf), from the energy of the newest samples
+  level = 10. * LOG10 (p->hop_energy / ibuf->length);
+  // once silent, the level has to rise above the threshold by the
+  // hysteresis to detect pitch again
+  if (p->silent) {
+    p->silent = (level < p->silence + p->hysteresis);
+  } else {
+    p->silent = (level < p->silence);
+  }
+  p->skipped = (p->silent && p->skip_cb != NULL);
+  if (p->skipped) {
+    p->skip_cb (p, ibuf);
+  } else {
+    p->detect_cb (p, ibuf, obuf);
+  }
+  if (p->silent) {
     obuf->data[0] = 0.;
   }
   obuf->data[0] = p->conv_cb (obuf->data[0], p->samplerate, p->bufsize);
 }
 
+void
+aubio_pitch_prime (aubio_pitch_t * p)
+{
+  fvec_t *silence = new_fvec (p->hopsize);
+  fvec_t *out = new_fvec (1);
+  // the rings of a new detector are silent, writing them only touches
+  // their pages
+  fvec_zeros (p->ring);
+  fvec_zeros (p->squares_ring);
+  // slide and detect a hop of silence, leaving the detector as if it had
+  // analysed one more window of the silence it starts from, without the
+  // skip of aubio_pitch_do
+  aubio_pitch_slideblock (p, silence);
+  p->detect_cb (p, silence, out);
+  del_fvec (out);
+  del_fvec (silence);
+}
+
 /* do method for each algorithm */
 void
 aubio_pitch_do_mcomb (aubio_pitch_t * p, const fvec_t * ibuf, fvec_t * obuf)
@@ -416,11 +723,10 @@ aubio_pitch_do_mcomb (aubio_pitch_t * p, const fvec_t * ibuf, fvec_t * obuf)
 }
 
 void
-aubio_pitch_do_yin (aubio_pitch_t * p, const fvec_t * ibuf, fvec_t * obuf)
+aubio_pitch_do_yin (aubio_pitch_t * p, const fvec_t * ibuf UNUSED, fvec_t * obuf)
 {
   smpl_t pitch = 0.;
-  aubio_pitch_slideblock (p, ibuf);
-  aubio_pitchyin_do (p->p_object, p->buf, obuf);
+  aubio_pitchyin_do (p->p_object, &p->buf, obuf);
   pitch = obuf->data[0];
   if (pitch > 0) {
     pitch = p->samplerate / (pitch + 0.);
@@ -432,11 +738,10 @@ aubio_pitch_do_yin (aubio_pitch_t * p, const fvec_t * ibuf, fvec_t * obuf)
 
 
 void
-aubio_pitch_do_yinfft (aubio_pitch_t * p, const fvec_t * ibuf, fvec_t * obuf)
+aubio_pitch_do_yinfft (aubio_pitch_t * p, const fvec_t * ibuf UNUSED, fvec_t * obuf)
 {
   smpl_t pitch = 0.;
-  aubio_pitch_slideblock (p, ibuf);
-  aubio_pitchyinfft_do (p->p_object, p->buf, obuf);
+  aubio_pitchyinfft_do (p->p_object, &p->buf, obuf);
   pitch = obuf->data[0];
   if (pitch > 0) {
     pitch = p->samplerate / (pitch + 0.);
@@ -447,11 +752,11 @@ aubio_pitch_do_yinfft (aubio_pitch_t * p, const fvec_t * ibuf, fvec_t * obuf)
 }
 
 void
-aubio_pitch_do_yinfast (aubio_pitch_t * p, const fvec_t * ibuf, fvec_t * obuf)
+aubio_pitch_do_yinfast (aubio_pitch_t * p, const fvec_t * ibuf UNUSED, fvec_t * obuf)
 {
   smpl_t pitch = 0.;
-  aubio_pitch_slideblock (p, ibuf);
-  aubio_pitchyinfast_do (p->p_object, p->buf, obuf);
+  aubio_pitchyinfast_do_squared (p->p_object, &p->buf, &p->squares,
+      p->head_energy, obuf);
   pitch = obuf->data[0];
   if (pitch > 0) {
     pitch = p->samplerate / (pitch + 0.);
@@ -462,11 +767,10 @@ aubio_pitch_do_yinfast (aubio_pitch_t * p, const fvec_t * ibuf, fvec_t * obuf)
 }
 
 void
-aubio_pitch_do_specacf (aubio_pitch_t * p, const fvec_t * ibuf, fvec_t * out)
+aubio_pitch_do_specacf (aubio_pitch_t * p, const fvec_t * ibuf UNUSED, fvec_t * out)
 {
   smpl_t pitch = 0., period;
-  aubio_pitch_slideblock (p, ibuf);
-  aubio_pitchspecacf_do (p->p_object, p->buf, out);
+  aubio_pitchspecacf_do (p->p_object, &p->buf, out);
   //out->data[0] = aubio_bintofreq (out->data[0], p->samplerate, p->bufsize);
   period = out->data[0];
   if (period > 0) {
@@ -478,19 +782,45 @@ aubio_pitch_do_specacf (aubio_pitch_t * p, const fvec_t * ibuf, fvec_t * out)
 }
 
 void
-aubio_pitch_do_fcomb (aubio_pitch_t * p, const fvec_t * ibuf, fvec_t * out)
+aubio_pitch_do_mpm (aubio_pitch_t * p, const fvec_t * ibuf UNUSED, fvec_t * obuf)
 {
-  aubio_pitch_slideblock (p, ibuf);
-  aubio_pitchfcomb_do (p->p_object, p->buf, out);
+  smpl_t pitch = 0.;
+  aubio_pitchmpm_do (p->p_object, &p->buf, obuf);
+  pitch = obuf->data[0];
+  if (pitch > 0) {
+    pitch = p->samplerate / (pitch + 0.);
+  } else {
+    pitch = 0.;
+  }
+  obuf->data[0] = pitch;
+}
+
+void
+aubio_pitch_do_bitacf (aubio_pitch_t * p, const fvec_t * ibuf UNUSED, fvec_t * obuf)
+{
+  smpl_t pitch = 0.;
+  aubio_pitchbitacf_do (p->p_object, &p->buf, obuf);
+  pitch = obuf->data[0];
+  if (pitch > 0) {
+    pitch = p->samplerate / (pitch + 0.);
+  } else {
+    pitch = 0.;
+  }
+  obuf->data[0] = pitch;
+}
+
+void
+aubio_pitch_do_fcomb (aubio_pitch_t * p, const fvec_t * ibuf UNUSED, fvec_t * out)
+{
+  aubio_pitchfcomb_do (p->p_object, &p->buf, out);
   out->data[0] = aubio_bintofreq (out->data[0], p->samplerate, p->bufsize);
 }
 
 void
-aubio_pitch_do_schmitt (aubio_pitch_t * p, const fvec_t * ibuf, fvec_t * out)
+aubio_pitch_do_schmitt (aubio_pitch_t * p, const fvec_t * ibuf UNUSED, fvec_t * out)
 {
   smpl_t period, pitch = 0.;
-  aubio_pitch_slideblock (p, ibuf);
-  aubio_pitchschmitt_do (p->p_object, p->buf, out);
+  aubio_pitchschmitt_do (p->p_object, &p->buf, out);
   period = out->data[0];
   if (period > 0) {
     pitch = p->samplerate / period;
@@ -500,6 +830,25 @@ aubio_pitch_do_schmitt (aubio_pitch_t * p, const fvec_t * ibuf, fvec_t * out)
   out->data[0] = pitch;
 }
 
+/* skip callbacks, keeping the detector state in step with the input buffer
+ * slid by aubio_pitch_do */
+void
+aubio_pitch_skip_none (aubio_pitch_t * p UNUSED, const fvec_t * ibuf UNUSED)
+{
+}
+
+void
+aubio_pitch_skip_yin (aubio_pitch_t * p, const fvec_t * ibuf UNUSED)
+{
+  aubio_pitchyin_skip (p->p_object);
+}
+
+void
+aubio_pitch_skip_yinfast (aubio_pitch_t * p, const fvec_t * ibuf UNUSED)
+{
+  aubio_pitchyinfast_skip (p->p_object);
+}
+
 /* conversion callbacks */
 smpl_t
 freqconvbin(smpl_t f, uint_t samplerate, uint_t bufsize)
@@ -523,7 +872,7 @@ freqconvpass (smpl_t f, uint_t samplerate UNUSED, uint_t bufsize UNUSED)
 smpl_t
 aubio_pitch_get_confidence (aubio_pitch_t * p)
 {
-  if (p->conf_cb) {
+  if (p->conf_cb && !p->skipped) {
     return p->conf_cb(p->p_object);
   }
   return 0.;
@@ -97,6 +97,25 @@ extern "C" {
   systems](http://aubio.org/phd/), Chapter 3, Pitch Analysis, PhD thesis,
   Centre for Digital music, Queen Mary University of London, London, UK, 2006.
 
+  \b \p mpm : McLeod Pitch Method
+
+  This algorithm picks the first key maximum of the normalised square
+  difference function that reaches a fraction of the highest one. It finds
+  periods up to nearly the buffer size, so that smaller buffers can be used
+  than with YIN for the same lowest note. See new_aubio_pitchmpm() for the
+  buffer sizes accepted.
+
+  McLeod, P., Wyvill, G. (2005) "A smarter way to find pitch", Proceedings of
+  the International Computer Music Conference (ICMC), Barcelona, Spain.
+
+  \b \p bitacf : Bitstream autocorrelation
+
+  This algorithm keeps only the sign of each sample, packed 64 samples to a
+  machine word, and compares the bitstream with itself at each lag using
+  exclusive or and bit counting. The period found is refined on the input
+  samples. It is cheaper than the other methods on pitched input, but only
+  reliable on signals with a strong fundamental.
+
   \example pitch/test-pitch.c
   \example examples/aubiopitch.c
 
@@ -111,9 +130,52 @@ typedef struct _aubio_pitch_t aubio_pitch_t;
   \param in input signal of size [hop_size]
   \param out output pitch candidates of size [1]
 
+  When the level of `in` is below the silence threshold, the output is 0.
+  Except with `mcomb` and `fcomb`, which keep state from every frame, the
+  detection is then skipped altogether, and only the input buffer of the
+  method is updated.
+
 */
 void aubio_pitch_do (aubio_pitch_t * o, const fvec_t * in, fvec_t * out);
 
+/** get where the next hop of input is to be written
+
+  \param o pitch detection object as returned by new_aubio_pitch()
+
+  \return view of [hop_size] samples in the input buffer of the detection,
+  following the last window analysed
+
+  Writing the hop there, then calling aubio_pitch_do_tail(), spares the
+  copy of the input done by aubio_pitch_do(). The view is owned by `o`, only
+  its samples are to be written, and it moves with each frame and with
+  aubio_pitch_prime(): its `data` pointer has to be read again after them.
+
+*/
+fvec_t *aubio_pitch_get_tail (aubio_pitch_t * o);
+
+/** execute pitch detection on the hop written to aubio_pitch_get_tail()
+
+  \param o pitch detection object as returned by new_aubio_pitch()
+  \param out output pitch candidates of size [1]
+
+  Same as aubio_pitch_do() on an input of those samples.
+
+*/
+void aubio_pitch_do_tail (aubio_pitch_t * o, fvec_t * out);
+
+/** run the detection once on silence, before the first aubio_pitch_do()
+
+  \param o pitch detection object as returned by new_aubio_pitch()
+
+  Writes to every buffer of the detection, which the system otherwise only
+  maps when aubio_pitch_do() first touches them, so that the first frame
+  costs no more than the following ones. Meant to be called on a new
+  object, outside of the audio thread: its state is then the same as
+  before, up to the position of its internal buffers.
+
+*/
+void aubio_pitch_prime (aubio_pitch_t * o);
+
 /** change yin or yinfft tolerance threshold
 
   \param o pitch detection object as returned by new_aubio_pitch()
@@ -181,11 +243,102 @@ uint_t aubio_pitch_set_silence (aubio_pitch_t * o, smpl_t silence);
 */
 smpl_t aubio_pitch_get_silence (aubio_pitch_t * o);
 
+/** set the silence hysteresis of the pitch detection object
+
+  \param o pitch detection object as returned by new_aubio_pitch()
+  \param hysteresis level above the silence threshold, in dB, that the input
+  has to reach to leave silence [default 0]
+
+  \return 0 if successfull, non-zero otherwise
+
+*/
+uint_t aubio_pitch_set_silence_hysteresis (aubio_pitch_t * o,
+    smpl_t hysteresis);
+
+/** get the silence hysteresis of the pitch detection object
+
+  \param o pitch detection object as returned by new_aubio_pitch()
+
+  \return level above the silence threshold needed to leave silence, in dB
+
+*/
+smpl_t aubio_pitch_get_silence_hysteresis (aubio_pitch_t * o);
+
+/** get whether the last frame was silent
+
+  \param o pitch detection object as returned by new_aubio_pitch()
+
+  \return 1 if the level of the last frame passed to aubio_pitch_do() was
+  below the silence threshold, taking the hysteresis into account, 0
+  otherwise
+
+*/
+uint_t aubio_pitch_get_silent (aubio_pitch_t * o);
+
+/** get the algorithmic delay of the pitch detection object
+
+  \param o pitch detection object as returned by new_aubio_pitch()
+
+  \return delay, in samples, between the end of the last input frame and the
+  centre of the signal the current estimate was computed from
+
+  Most methods analyse the whole window, and the delay is half the buffer
+  size. The `yin` and `yinfast` methods only compare its first half with
+  the samples one period later, their delay depends on the period found
+  and is given for a period of a quarter of the buffer size, five eighths
+  of it.
+
+*/
+uint_t aubio_pitch_get_delay (aubio_pitch_t * o);
+
+/** restrict the range of frequencies searched by the pitch detection object
+
+  \param o pitch detection object as returned by new_aubio_pitch()
+  \param min_freq lowest frequency to detect, in Hz
+  \param max_freq highest frequency to detect, in Hz
+
+  The `yin`, `yinfast`, `yinfft`, `mpm` and `bitacf` methods support a
+  frequency range. The first three skip the computation of the lags past the
+  period of `min_freq`, so a narrow range, together with a buffer size just
+  above twice that period, cuts the cost of the detection. `mpm` still
+  computes its correlation over the whole buffer, in one FFT, but stops
+  looking for key maxima a few lags past that period, and only selects a
+  maximum within the range, reporting no pitch when there is none. `bitacf`
+  counts the differing bits up to that period only, and searches its minimum
+  from the period of `max_freq`.
+
+  \return 0 if successful, non-zero if the range is invalid or the method
+  does not support it
+
+*/
+uint_t aubio_pitch_set_frequency_range (aubio_pitch_t * o, smpl_t min_freq,
+    smpl_t max_freq);
+
+/** get the magnitude spectrum of the last analysed buffer
+
+  \param o pitch detection object as returned by new_aubio_pitch()
+  \param spectrum output spectrum, of size `buf_size/2+1`, only the norm is
+  set
+
+  The spectrum comes from the Fourier transform the detection method already
+  computed, so it costs one pass over the bins. It can be passed to
+  aubio_onset_do_spectrum() to detect onsets without running a second phase
+  vocoder. Only `yinfft`, `specacf`, `fcomb` (Hanning window), `mcomb` (the
+  frame of its phase vocoder) and `yinfast` (no window) compute such a
+  transform. When the last frame was silent and its detection skipped, the
+  spectrum is set to zero.
+
+  \return 0 if successful, non-zero if the method computes no spectrum
+
+*/
+uint_t aubio_pitch_get_spectrum (aubio_pitch_t * o, cvec_t * spectrum);
+
 /** get the current confidence
 
   \param o pitch detection object as returned by new_aubio_pitch()
 
-  \return the current confidence of the pitch algorithm
+  \return the current confidence of the pitch algorithm, 0 when the
+  detection was skipped on a silent frame
 
 */
 smpl_t aubio_pitch_get_confidence (aubio_pitch_t * o);
@@ -0,0 +1,308 @@
+/*
+  Copyright (C) 2026 the audio-to-cv-pitch-lv2 contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include <stdint.h>
+#include "aubio_priv.h"
+#include "fvec.h"
+#include "mathutils.h"
+#include "pitch/yindiff.h"
+#include "pitch/pitchbitacf.h"
+
+/* the bits are counted with the popcnt instruction, or four words at a time
+ * with avx2, when the processor has them, through functions compiled with
+ * target attributes, so that the rest of the library keeps the baseline
+ * instruction set */
+#if (defined(__GNUC__) || defined(__clang__)) \
+  && (defined(__x86_64__) || defined(__i386__))
+#define HAVE_BITACF_X86 1
+#include <immintrin.h>
+#else
+#define HAVE_BITACF_X86 0
+#endif
+
+/** count the bits that differ between the first n_words words of a and b,
+ * the last word masked with last_mask */
+typedef uint_t (*aubio_pitchbitacf_count_t) (const uint64_t * a,
+    const uint64_t * b, uint_t n_words, uint64_t last_mask);
+
+struct _aubio_pitchbitacf_t
+{
+  uint64_t *bits;       /**< sign of each input sample, 64 per word */
+  uint64_t *shifted;    /**< bits shifted by 0 to 63 samples */
+  uint_t n_words;       /**< number of words in bits, with padding */
+  uint_t *counts;       /**< differing bits at each lag */
+  uint_t length;        /**< size of the input buffer */
+  aubio_pitchbitacf_count_t count; /**< bit counter for the processor */
+  aubio_yindiff_t diff; /**< difference kernel for the processor */
+  smpl_t tol;           /**< fraction of bits allowed to differ */
+  smpl_t confidence;    /**< correlation of the bitstreams at the period */
+  uint_t tau_min;       /**< shortest period searched */
+  uint_t tau_max;       /**< longest period searched */
+};
+
+static inline uint_t
+aubio_pitchbitacf_popcount (uint64_t w)
+{
+#if defined(__GNUC__)
+  return __builtin_popcountll (w);
+#else
+  w = w - ((w >> 1) & 0x5555555555555555ULL);
+  w = (w & 0x3333333333333333ULL) + ((w >> 2) & 0x3333333333333333ULL);
+  w = (w + (w >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+  return (uint_t)((w * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+static inline uint_t
+aubio_pitchbitacf_count_words (const uint64_t * a, const uint64_t * b,
+    uint_t n_words, uint64_t last_mask)
+{
+  uint_t i, count = 0;
+  for (i = 0; i < n_words - 1; i++) {
+    count += aubio_pitchbitacf_popcount (a[i] ^ b[i]);
+  }
+  return count + aubio_pitchbitacf_popcount ((a[i] ^ b[i]) & last_mask);
+}
+
+static uint_t
+aubio_pitchbitacf_count_scalar (const uint64_t * a, const uint64_t * b,
+    uint_t n_words, uint64_t last_mask)
+{
+  return aubio_pitchbitacf_count_words (a, b, n_words, last_mask);
+}
+
+#if HAVE_BITACF_X86
+__attribute__((target("popcnt")))
+static uint_t
+aubio_pitchbitacf_count_popcnt (const uint64_t * a, const uint64_t * b,
+    uint_t n_words, uint64_t last_mask)
+{
+  return aubio_pitchbitacf_count_words (a, b, n_words, last_mask);
+}
+
+/* count the bits of each nibble with a lookup table, then sum the bytes of
+ * each word */
+__attribute__((target("avx2,popcnt")))
+static uint_t
+aubio_pitchbitacf_count_avx2 (const uint64_t * a, const uint64_t * b,
+    uint_t n_words, uint64_t last_mask)
+{
+  const __m256i table = _mm256_setr_epi8 (0, 1, 1, 2, 1, 2, 2, 3,
+      1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+  const __m256i nibble = _mm256_set1_epi8 (0x0f);
+  __m256i sum = _mm256_setzero_si256 ();
+  uint64_t lanes[4];
+  uint_t i;
+  for (i = 0; i + 4 < n_words; i += 4) {
+    __m256i v = _mm256_xor_si256 (
+        _mm256_loadu_si256 ((const __m256i *)(a + i)),
+        _mm256_loadu_si256 ((const __m256i *)(b + i)));
+    __m256i lo = _mm256_shuffle_epi8 (table, _mm256_and_si256 (v, nibble));
+    __m256i hi = _mm256_shuffle_epi8 (table,
+        _mm256_and_si256 (_mm256_srli_epi16 (v, 4), nibble));
+    sum = _mm256_add_epi64 (sum, _mm256_sad_epu8 (_mm256_add_epi8 (lo, hi),
+          _mm256_setzero_si256 ()));
+  }
+  _mm256_storeu_si256 ((__m256i *)lanes, sum);
+  return (uint_t)(lanes[0] + lanes[1] + lanes[2] + lanes[3])
+    + aubio_pitchbitacf_count_words (a + i, b + i, n_words - i, last_mask);
+}
+#endif /* HAVE_BITACF_X86 */
+
+static aubio_pitchbitacf_count_t
+aubio_pitchbitacf_get_count (void)
+{
+#if HAVE_BITACF_X86
+  __builtin_cpu_init ();
+  if (__builtin_cpu_supports ("avx2") && __builtin_cpu_supports ("popcnt")) {
+    return aubio_pitchbitacf_count_avx2;
+  }
+  if (__builtin_cpu_supports ("popcnt")) {
+    return aubio_pitchbitacf_count_popcnt;
+  }
+#endif /* HAVE_BITACF_X86 */
+  return aubio_pitchbitacf_count_scalar;
+}
+
+aubio_pitchbitacf_t *
+new_aubio_pitchbitacf (uint_t bufsize)
+{
+  aubio_pitchbitacf_t *o = AUBIO_NEW (aubio_pitchbitacf_t);
+  if ((sint_t)bufsize < 16) {
+    AUBIO_ERR ("pitchbitacf: got buffer size %d, but can not be < 16\n",
+        bufsize);
+    goto beach;
+  }
+  // two more words, so that the bits past the buffer read when shifting by
+  // the longest lag are zeros
+  o->n_words = bufsize / 64 + 2;
+  o->bits = AUBIO_ARRAY (uint64_t, o->n_words);
+  o->shifted = AUBIO_ARRAY (uint64_t, 64 * o->n_words);
+  o->counts = AUBIO_ARRAY (uint_t, bufsize / 2);
+  o->length = bufsize;
+  o->count = aubio_pitchbitacf_get_count ();
+  o->diff = aubio_yindiff_get_kernel ();
+  o->tol = 0.1;
+  o->confidence = 0.;
+  o->tau_min = 2;
+  o->tau_max = bufsize / 2 - 3;
+  return o;
+
+beach:
+  AUBIO_FREE (o);
+  return NULL;
+}
+
+void
+del_aubio_pitchbitacf (aubio_pitchbitacf_t * o)
+{
+  AUBIO_FREE (o->bits);
+  AUBIO_FREE (o->shifted);
+  AUBIO_FREE (o->counts);
+  AUBIO_FREE (o);
+}
+
+void
+aubio_pitchbitacf_do (aubio_pitchbitacf_t * o, const fvec_t * input,
+    fvec_t * out)
+{
+  const uint_t length = o->length;
+  const uint_t half = length / 2;
+  const uint_t half_words = (half + 63) / 64;
+  const uint64_t last_mask = (half % 64) ?
+      (((uint64_t)1 << (half % 64)) - 1) : ~(uint64_t)0;
+  const uint_t tau_min = o->tau_min;
+  const uint_t tau_max = o->tau_max;
+  // one more lag than tau_max, to tell whether it is a local minimum
+  const uint_t tau_end = tau_max + 2;
+  const uint_t n_words = o->n_words;
+  const uint64_t *bits = o->bits;
+  uint_t *counts = o->counts;
+  const smpl_t tol = o->tol * half;
+  uint_t tau, start, period, best = 0, j, k;
+  smpl_t d[AUBIO_YINDIFF_LAGS];
+
+  // binarize the input, bit j of word k is set when sample 64 k + j is
+  // positive
+  for (k = 0; k < n_words; k++) {
+    uint64_t w = 0;
+    for (j = 0; j < 64 && 64 * k + j < length; j++) {
+      w |= (uint64_t)(input->data[64 * k + j] > 0.) << j;
+    }
+    o->bits[k] = w;
+  }
+
+  // shift the bitstream by each number of samples below 64 once, so that a
+  // lag is a whole number of words into one of the shifted copies. The high
+  // part is shifted in two steps, as shifting by the width of the word is
+  // undefined.
+  for (j = 0; j < 64; j++) {
+    uint64_t *shifted = o->shifted + j * n_words;
+    for (k = 0; k < n_words - 1; k++) {
+      shifted[k] = (bits[k] >> j) | ((bits[k + 1] << 1) << (63 - j));
+    }
+  }
+
+  // count the bits of the first half that differ from the bitstream shifted
+  // by each lag. Neighbouring samples mostly have the same sign, so the
+  // short lags are skipped until half of the bits differ, as the
+  // bitstreams stop being correlated.
+  for (tau = 1; tau < tau_end; tau++) {
+    counts[tau] = o->count (bits, o->shifted + (tau % 64) * n_words
+        + tau / 64, half_words, last_mask);
+    if (2 * counts[tau] >= half) break;
+  }
+  start = MAX (tau, tau_min);
+
+  // select the first local minimum below the tolerance, the lags past it
+  // are not needed. Without one, use the lowest count in the range.
+  period = 0;
+  for (tau = MAX (tau + 1, tau_min); tau < tau_end; tau++) {
+    counts[tau] = o->count (bits, o->shifted + (tau % 64) * n_words
+        + tau / 64, half_words, last_mask);
+    if (tau - 1 < start) continue;
+    if (best == 0 || counts[tau - 1] < counts[best]) {
+      best = tau - 1;
+    }
+    if (counts[tau - 1] <= tol && counts[tau - 1] <= counts[tau]
+        && (tau - 1 == start || counts[tau - 1] < counts[tau - 2])) {
+      period = tau - 1;
+      break;
+    }
+  }
+  if (period == 0 && best != start && best != tau_max) {
+    // the lowest count on an edge of the searched lags lies outside them
+    period = best;
+  }
+  if (period == 0) {
+    o->confidence = 0.;
+    out->data[0] = 0.;
+    return;
+  }
+  o->confidence = MAX (0., 1. - 2. * counts[period] / half);
+
+  // refine on the input samples: move to the lowest square difference among
+  // the neighbouring lags, then interpolate around it
+  o->diff (input->data, 0, half, period - 1, AUBIO_YINDIFF_LAGS, d);
+  k = 1;
+  if (d[0] < d[k]) k = 0;
+  if (d[2] < d[k]) k = 2;
+  out->data[0] = period - 1 + k;
+  if (k > 0) {
+    smpl_t s0 = d[k - 1], s1 = d[k], s2 = d[k + 1];
+    smpl_t denom = s0 - 2. * s1 + s2;
+    if (denom > 0.) {
+      out->data[0] += .5 * (s0 - s2) / denom;
+    }
+  }
+}
+
+smpl_t
+aubio_pitchbitacf_get_confidence (aubio_pitchbitacf_t * o) {
+  return o->confidence;
+}
+
+uint_t
+aubio_pitchbitacf_set_tolerance (aubio_pitchbitacf_t * o, smpl_t tol)
+{
+  o->tol = tol;
+  return 0;
+}
+
+smpl_t
+aubio_pitchbitacf_get_tolerance (aubio_pitchbitacf_t * o)
+{
+  return o->tol;
+}
+
+uint_t
+aubio_pitchbitacf_set_tau_range (aubio_pitchbitacf_t * o, uint_t tau_min,
+    uint_t tau_max)
+{
+  uint_t last = o->length / 2 - 3;
+  if (tau_min > tau_max) {
+    AUBIO_ERR ("pitchbitacf: tau_min (%d) is larger than tau_max (%d)\n",
+        tau_min, tau_max);
+    return AUBIO_FAIL;
+  }
+  o->tau_min = MIN (MAX (tau_min, 2), last);
+  o->tau_max = MIN (MAX (tau_max, 2), last);
+  return AUBIO_OK;
+}
@@ -0,0 +1,119 @@
+/*
+  Copyright (C) 2026 the audio-to-cv-pitch-lv2 contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/** \file
+
+  Pitch detection using a bitstream autocorrelation
+
+  The input buffer is reduced to one bit per sample, set when the sample is
+  positive, and packed into 64 bit words. The first half of the bitstream is
+  compared with the bitstream shifted by each lag using exclusive or and bit
+  counting, 64 samples at a time. The period is the first lag at which few
+  enough bits differ, or the one at which the fewest differ, refined to a
+  fraction of a sample with the square difference function of the original
+  samples around it.
+
+  This trades some robustness for speed: the bitstream only keeps the zero
+  crossings of the signal, which is enough for signals with a strong
+  fundamental but not for those with strong harmonics crossing zero more
+  than twice per period.
+
+*/
+
+#ifndef AUBIO_PITCHBITACF_H
+#define AUBIO_PITCHBITACF_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** pitch detection object */
+typedef struct _aubio_pitchbitacf_t aubio_pitchbitacf_t;
+
+/** creation of the pitch detection object
+
+  \param buf_size size of the input buffer to analyse
+
+*/
+aubio_pitchbitacf_t *new_aubio_pitchbitacf (uint_t buf_size);
+
+/** deletion of the pitch detection object
+
+  \param o pitch detection object as returned by new_aubio_pitchbitacf()
+
+*/
+void del_aubio_pitchbitacf (aubio_pitchbitacf_t * o);
+
+/** execute pitch detection on an input buffer
+
+  \param o pitch detection object as returned by new_aubio_pitchbitacf()
+  \param samples_in input signal vector (length as specified at creation time)
+  \param cands_out pitch period candidates, in samples
+
+*/
+void aubio_pitchbitacf_do (aubio_pitchbitacf_t * o, const fvec_t * samples_in,
+    fvec_t * cands_out);
+
+/** set tolerance parameter for the bitstream autocorrelation
+
+  \param o bitstream autocorrelation pitch detection object
+  \param tol fraction of the compared bits that may differ at the selected
+  lag [default 0.1]
+
+*/
+uint_t aubio_pitchbitacf_set_tolerance (aubio_pitchbitacf_t * o, smpl_t tol);
+
+/** get tolerance parameter for the bitstream autocorrelation
+
+  \param o bitstream autocorrelation pitch detection object
+  \return fraction of the compared bits that may differ at the selected lag
+  [default 0.1]
+
+*/
+smpl_t aubio_pitchbitacf_get_tolerance (aubio_pitchbitacf_t * o);
+
+/** get current confidence of the bitstream autocorrelation
+
+  \param o bitstream autocorrelation pitch detection object
+  \return correlation of the bitstreams at the selected lag, 1 when no bit
+  differs and 0 when half of them do
+
+*/
+smpl_t aubio_pitchbitacf_get_confidence (aubio_pitchbitacf_t * o);
+
+/** restrict the range of periods searched by the bitstream autocorrelation
+
+  \param o bitstream autocorrelation pitch detection object
+  \param tau_min shortest period, in samples [default 2]
+  \param tau_max longest period, in samples [default buf_size/2 - 3]
+
+  Both values are clipped to `[2, buf_size/2 - 3]`.
+
+  \return 0 if successful, non-zero otherwise
+
+*/
+uint_t aubio_pitchbitacf_set_tau_range (aubio_pitchbitacf_t * o,
+    uint_t tau_min, uint_t tau_max);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AUBIO_PITCHBITACF_H */
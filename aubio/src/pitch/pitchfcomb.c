@@ -26,6 +26,7 @@
 #include "musicutils.h"
 #include "spectral/fft.h"
 #include "pitch/pitchfcomb.h"
+#include "utils/cache.h"
 
 #define MAX_PEAKS 8
 
@@ -58,7 +59,7 @@ new_aubio_pitchfcomb (uint_t bufsize, uint_t hopsize)
   p->winput = new_fvec (bufsize);
   p->fftOut = new_cvec (bufsize);
   p->fftLastPhase = new_fvec (bufsize);
-  p->win = new_aubio_window ("hanning", bufsize);
+  p->win = aubio_cache_acquire_window ("hanning", bufsize);
   return p;
 
 beach:
@@ -132,12 +133,18 @@ aubio_pitchfcomb_do (aubio_pitchfcomb_t * p, const fvec_t * input, fvec_t * outp
     output->data[0] = 0.;
 }
 
+void
+aubio_pitchfcomb_get_spectrum (const aubio_pitchfcomb_t * p, cvec_t * spectrum)
+{
+  memcpy (spectrum->norm, p->fftOut->norm, spectrum->length * sizeof (smpl_t));
+}
+
 void
 del_aubio_pitchfcomb (aubio_pitchfcomb_t * p)
 {
   del_cvec (p->fftOut);
   del_fvec (p->fftLastPhase);
-  del_fvec (p->win);
+  aubio_cache_release_fvec (p->win);
   del_fvec (p->winput);
   del_aubio_fft (p->fft);
   AUBIO_FREE (p);
@@ -62,6 +62,19 @@ void aubio_pitchfcomb_do (aubio_pitchfcomb_t * p, const fvec_t * input,
 */
 aubio_pitchfcomb_t *new_aubio_pitchfcomb (uint_t buf_size, uint_t hop_size);
 
+/** get the magnitude spectrum of the last analysed buffer
+
+  \param p pitch detection object as returned by new_aubio_pitchfcomb
+  \param spectrum output spectrum, of size `buf_size/2+1`, only the norm is
+  set
+
+  The spectrum is the one computed by aubio_pitchfcomb_do(), on the input
+  buffer multiplied by a Hanning window.
+
+*/
+void aubio_pitchfcomb_get_spectrum (const aubio_pitchfcomb_t * p,
+    cvec_t * spectrum);
+
 /** deletion of the pitch detection object
 
   \param p pitch detection object as returned by new_aubio_pitchfcomb
@@ -0,0 +1,192 @@
+/*
+  Copyright (C) 2026 the audio-to-cv-pitch-lv2 contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/* This algorithm was developed by P. McLeod and G. Wyvill and published in:
+ *
+ * McLeod, P., Wyvill, G. (2005) "A smarter way to find pitch", Proceedings
+ * of the International Computer Music Conference (ICMC), Barcelona, Spain.
+ */
+
+#include "aubio_priv.h"
+#include "fvec.h"
+#include "mathutils.h"
+#include "cvec.h"
+#include "spectral/fft.h"
+#include "pitch/pitchmpm.h"
+
+/** highest key maximum under which no period is reported */
+#define AUBIO_PITCHMPM_MIN_CLARITY 0.5
+
+struct _aubio_pitchmpm_t
+{
+  fvec_t *nsdf;       /**< normalised square difference function */
+  fvec_t *acf;        /**< autocorrelation of the zero padded input */
+  aubio_fft_t *fft;   /**< fft object of twice the buffer size */
+  uint_t *maxima;     /**< lags of the key maxima */
+  smpl_t tol;         /**< fraction of the highest key maximum to reach */
+  smpl_t clarity;     /**< value of the NSDF at the selected key maximum */
+  uint_t tau_min;     /**< shortest period searched */
+  uint_t tau_max;     /**< longest period searched */
+};
+
+aubio_pitchmpm_t *
+new_aubio_pitchmpm (uint_t bufsize)
+{
+  aubio_pitchmpm_t *o = AUBIO_NEW (aubio_pitchmpm_t);
+  if ((sint_t)bufsize < 4) {
+    AUBIO_ERR ("pitchmpm: got buffer size %d, but can not be < 4\n", bufsize);
+    goto beach;
+  }
+  // zero padded to twice the buffer size, so that the autocorrelation
+  // computed in the spectral domain is not circular
+  o->fft = new_aubio_fft (2 * bufsize);
+  if (!o->fft) goto beach;
+  o->nsdf = new_fvec (bufsize);
+  o->acf = new_fvec (2 * bufsize);
+  o->maxima = AUBIO_ARRAY (uint_t, bufsize / 2 + 1);
+  o->tol = 0.93;
+  o->clarity = 0.;
+  o->tau_min = 0;
+  o->tau_max = bufsize - 2;
+  return o;
+
+beach:
+  AUBIO_FREE (o);
+  return NULL;
+}
+
+void
+del_aubio_pitchmpm (aubio_pitchmpm_t * o)
+{
+  del_fvec (o->nsdf);
+  del_fvec (o->acf);
+  del_aubio_fft (o->fft);
+  AUBIO_FREE (o->maxima);
+  AUBIO_FREE (o);
+}
+
+void
+aubio_pitchmpm_do (aubio_pitchmpm_t * o, const fvec_t * input, fvec_t * out)
+{
+  const uint_t length = o->nsdf->length;
+  const uint_t tau_min = o->tau_min;
+  const uint_t tau_max = o->tau_max;
+  // stop a few lags past tau_max, enough to close its lobe and interpolate
+  const uint_t tau_end = MIN (tau_max + 4, length);
+  smpl_t *nsdf = o->nsdf->data;
+  smpl_t *acf = o->acf->data;
+  uint_t *maxima = o->maxima;
+  uint_t n_maxima = 0, tau, pos = 0, j;
+  smpl_t energy = 0., highest = 0.;
+  fvec_t padded;
+
+  // compute r'(tau) = ifft(|fft(samples zero padded)|^2)
+  for (j = 0; j < length; j++) {
+    acf[j] = input->data[j];
+  }
+  padded.data = acf + length;
+  padded.length = length;
+  fvec_zeros (&padded);
+  aubio_fft_do_packed (o->fft, o->acf);
+  aubio_fft_packed_mul_conj (o->acf, o->acf, o->acf);
+  aubio_fft_rdo_packed (o->fft, o->acf);
+
+  // compute m'(tau), the energy of both overlapping parts, and the NSDF
+  // n'(tau) = 2 r'(tau) / m'(tau)
+  for (j = 0; j < length; j++) {
+    energy += SQR (input->data[j]);
+  }
+  energy *= 2.;
+  for (tau = 0; tau < tau_end; tau++) {
+    nsdf[tau] = (energy > 0.) ? 2. * acf[tau] / energy : 0.;
+    energy -= SQR (input->data[tau]) + SQR (input->data[length - 1 - tau]);
+  }
+
+  // find the key maxima, the highest point of each positive lobe after the
+  // one at lag 0
+  for (tau = 1; tau < tau_end && nsdf[tau] > 0.; tau++);
+  for (; tau < tau_end; tau++) {
+    if (nsdf[tau] > 0.) {
+      if (pos == 0 || nsdf[tau] > nsdf[pos]) {
+        pos = tau;
+      }
+    } else if (pos != 0) {
+      maxima[n_maxima++] = pos;
+      pos = 0;
+    }
+  }
+  // a lobe not closed at the last lag counts if its maximum is inside it
+  if (pos != 0 && pos + 1 < tau_end) {
+    maxima[n_maxima++] = pos;
+  }
+
+  // select the first key maximum reaching a fraction of the highest one
+  for (j = 0; j < n_maxima; j++) {
+    if (maxima[j] >= tau_min && maxima[j] <= tau_max) {
+      highest = MAX (highest, nsdf[maxima[j]]);
+    }
+  }
+  o->clarity = 0.;
+  out->data[0] = 0.;
+  if (highest < AUBIO_PITCHMPM_MIN_CLARITY) {
+    return;
+  }
+  for (j = 0; j < n_maxima; j++) {
+    pos = maxima[j];
+    if (pos >= tau_min && pos <= tau_max && nsdf[pos] >= o->tol * highest) {
+      out->data[0] = fvec_quadratic_peak_pos (o->nsdf, pos);
+      o->clarity = fvec_quadratic_peak_mag (o->nsdf, out->data[0]);
+      return;
+    }
+  }
+}
+
+smpl_t
+aubio_pitchmpm_get_confidence (aubio_pitchmpm_t * o) {
+  return o->clarity;
+}
+
+uint_t
+aubio_pitchmpm_set_tolerance (aubio_pitchmpm_t * o, smpl_t tol)
+{
+  o->tol = tol;
+  return 0;
+}
+
+smpl_t
+aubio_pitchmpm_get_tolerance (aubio_pitchmpm_t * o)
+{
+  return o->tol;
+}
+
+uint_t
+aubio_pitchmpm_set_tau_range (aubio_pitchmpm_t * o, uint_t tau_min,
+    uint_t tau_max)
+{
+  uint_t last = o->nsdf->length - 2;
+  if (tau_min > tau_max) {
+    AUBIO_ERR ("pitchmpm: tau_min (%d) is larger than tau_max (%d)\n",
+        tau_min, tau_max);
+    return AUBIO_FAIL;
+  }
+  o->tau_min = MIN (tau_min, last);
+  o->tau_max = MIN (tau_max, last);
+  return AUBIO_OK;
+}
@@ -0,0 +1,125 @@
+/*
+  Copyright (C) 2026 the audio-to-cv-pitch-lv2 contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/** \file
+
+  Pitch detection using the McLeod Pitch Method
+
+  This algorithm was developed by P. McLeod and G. Wyvill and published in:
+
+  McLeod, P., Wyvill, G. (2005) "A smarter way to find pitch", Proceedings of
+  the International Computer Music Conference (ICMC), Barcelona, Spain.
+
+  The normalised square difference function (NSDF) is computed from the
+  autocorrelation of the zero padded buffer, obtained in the spectral domain.
+  The period is given by the first key maximum of the NSDF that reaches a
+  fraction of the highest one. Since the NSDF is normalised by the energy of
+  the overlapping part of the buffer at each lag, periods up to nearly the
+  buffer size can be found, where YIN needs a buffer of at least two
+  periods.
+
+*/
+
+#ifndef AUBIO_PITCHMPM_H
+#define AUBIO_PITCHMPM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** pitch detection object */
+typedef struct _aubio_pitchmpm_t aubio_pitchmpm_t;
+
+/** creation of the pitch detection object
+
+  \param buf_size size of the input buffer to analyse
+
+  The correlation is computed with a packed FFT of twice `buf_size`, which is
+  always even: any size works with Ooura, FFTW3 and the built-in fft, the
+  fastest having no prime factor other than 2, 3 and 5, while vDSP and Intel
+  IPP need a power of two. See new_aubio_fft().
+
+*/
+aubio_pitchmpm_t *new_aubio_pitchmpm (uint_t buf_size);
+
+/** deletion of the pitch detection object
+
+  \param o pitch detection object as returned by new_aubio_pitchmpm()
+
+*/
+void del_aubio_pitchmpm (aubio_pitchmpm_t * o);
+
+/** execute pitch detection on an input buffer
+
+  \param o pitch detection object as returned by new_aubio_pitchmpm()
+  \param samples_in input signal vector (length as specified at creation time)
+  \param cands_out pitch period candidates, in samples, 0 when no key maximum
+  of the NSDF reaches 0.5
+
+*/
+void aubio_pitchmpm_do (aubio_pitchmpm_t * o, const fvec_t * samples_in,
+    fvec_t * cands_out);
+
+/** set tolerance parameter for the McLeod Pitch Method
+
+  \param o MPM pitch detection object
+  \param tol fraction of the highest key maximum that the selected key
+  maximum has to reach [default 0.93]
+
+*/
+uint_t aubio_pitchmpm_set_tolerance (aubio_pitchmpm_t * o, smpl_t tol);
+
+/** get tolerance parameter for the McLeod Pitch Method
+
+  \param o MPM pitch detection object
+  \return fraction of the highest key maximum that the selected key maximum
+  has to reach [default 0.93]
+
+*/
+smpl_t aubio_pitchmpm_get_tolerance (aubio_pitchmpm_t * o);
+
+/** get current confidence of the McLeod Pitch Method
+
+  \param o MPM pitch detection object
+  \return value of the NSDF at the selected key maximum, its clarity
+
+*/
+smpl_t aubio_pitchmpm_get_confidence (aubio_pitchmpm_t * o);
+
+/** restrict the range of periods searched by the McLeod Pitch Method
+
+  \param o MPM pitch detection object
+  \param tau_min shortest period, in samples [default 0]
+  \param tau_max longest period, in samples [default buf_size - 2]
+
+  The NSDF is only computed up to a few samples past `tau_max`. Both values
+  are clipped to `buf_size - 2`.
+
+  \return 0 if successful, non-zero otherwise
+
+*/
+uint_t aubio_pitchmpm_set_tau_range (aubio_pitchmpm_t * o, uint_t tau_min,
+    uint_t tau_max);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AUBIO_PITCHMPM_H */
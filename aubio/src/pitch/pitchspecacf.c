@@ -24,15 +24,15 @@
 #include "mathutils.h"
 #include "spectral/fft.h"
 #include "pitch/pitchspecacf.h"
+#include "utils/cache.h"
 
 /** pitch specacf structure */
 struct _aubio_pitchspecacf_t
 {
   fvec_t *win;        /**< temporal weighting window */
-  fvec_t *winput;     /**< windowed spectrum */
   aubio_fft_t *fft;   /**< fft object to compute*/
   fvec_t *fftout;     /**< Fourier transform output */
-  fvec_t *sqrmag;     /**< square magnitudes */
+  fvec_t *spectrum;   /**< Fourier transform of the windowed input */
   fvec_t *acf;        /**< auto correlation function */
   smpl_t tol;         /**< tolerance */
   smpl_t confidence;  /**< confidence */
@@ -44,10 +44,9 @@ new_aubio_pitchspecacf (uint_t bufsize)
   aubio_pitchspecacf_t *p = AUBIO_NEW (aubio_pitchspecacf_t);
   p->fft = new_aubio_fft (bufsize);
   if (!p->fft) goto beach;
-  p->win = new_aubio_window ("hanningz", bufsize);
-  p->winput = new_fvec (bufsize);
+  p->win = aubio_cache_acquire_window ("hanningz", bufsize);
   p->fftout = new_fvec (bufsize);
-  p->sqrmag = new_fvec (bufsize);
+  p->spectrum = new_fvec (bufsize);
   p->acf = new_fvec (bufsize / 2 + 1);
   p->tol = 1.;
   p->confidence = 0.;
@@ -62,22 +61,29 @@ void
 aubio_pitchspecacf_do (aubio_pitchspecacf_t * p, const fvec_t * input, fvec_t * output)
 {
   uint_t l, tau;
+  uint_t length = p->fftout->length;
   fvec_t *fftout = p->fftout;
   // window the input
   for (l = 0; l < input->length; l++) {
-    p->winput->data[l] = p->win->data[l] * input->data[l];
+    p->spectrum->data[l] = p->win->data[l] * input->data[l];
   }
-  // get the real / imag parts of its fft
-  aubio_fft_do_complex (p->fft, p->winput, fftout);
-  for (l = 0; l < input->length / 2 + 1; l++) {
-    p->sqrmag->data[l] = SQR(fftout->data[l]);
+  // get the packed real / imag parts of its fft
+  aubio_fft_do_packed (p->fft, p->spectrum);
+  // square the real parts, zero padded to the buffer size
+  fvec_zeros (fftout);
+  fftout->data[0] = SQR(p->spectrum->data[0]);
+  for (l = 1; l < length / 2; l++) {
+    fftout->data[l] = SQR(p->spectrum->data[2 * l]);
   }
-  // get the real / imag parts of the fft of the squared magnitude
-  aubio_fft_do_complex (p->fft, p->sqrmag, fftout);
+  fftout->data[length / 2] = SQR(p->spectrum->data[1]);
+  // get the packed real / imag parts of the fft of the squared magnitude
+  aubio_fft_do_packed (p->fft, fftout);
   // copy real part to acf
-  for (l = 0; l < fftout->length / 2 + 1; l++) {
-    p->acf->data[l] = fftout->data[l];
+  p->acf->data[0] = fftout->data[0];
+  for (l = 1; l < length / 2; l++) {
+    p->acf->data[l] = fftout->data[2 * l];
   }
+  p->acf->data[length / 2] = fftout->data[1];
   // get the minimum
   tau = fvec_min_elem (p->acf);
   // get the interpolated minimum
@@ -87,14 +93,21 @@ aubio_pitchspecacf_do (aubio_pitchspecacf_t * p, const fvec_t * input, fvec_t *
 void
 del_aubio_pitchspecacf (aubio_pitchspecacf_t * p)
 {
-  del_fvec (p->win);
-  del_fvec (p->winput);
+  aubio_cache_release_fvec (p->win);
   del_aubio_fft (p->fft);
-  del_fvec (p->sqrmag);
   del_fvec (p->fftout);
+  del_fvec (p->spectrum);
+  del_fvec (p->acf);
   AUBIO_FREE (p);
 }
 
+void
+aubio_pitchspecacf_get_spectrum (const aubio_pitchspecacf_t * o,
+    cvec_t * spectrum)
+{
+  aubio_fft_packed_get_norm (o->spectrum, spectrum);
+}
+
 smpl_t
 aubio_pitchspecacf_get_confidence (const aubio_pitchspecacf_t * o) {
   // no confidence for now
@@ -96,6 +96,19 @@ uint_t aubio_pitchspecacf_set_tolerance (aubio_pitchspecacf_t * o, smpl_t tol);
 */
 smpl_t aubio_pitchspecacf_get_confidence (const aubio_pitchspecacf_t * o);
 
+/** get the magnitude spectrum of the last analysed buffer
+
+  \param o `specacf` pitch detection object
+  \param spectrum output spectrum, of size `buf_size/2+1`, only the norm is
+  set
+
+  The spectrum is the one computed by aubio_pitchspecacf_do(), on the input
+  buffer multiplied by a Hanning window.
+
+*/
+void aubio_pitchspecacf_get_spectrum (const aubio_pitchspecacf_t * o,
+    cvec_t * spectrum);
+
 #ifdef __cplusplus
 }
 #endif
@@ -29,14 +29,23 @@
 
 #include "aubio_priv.h"
 #include "fvec.h"
+#include "fmat.h"
 #include "mathutils.h"
 #include "pitch/pitchyin.h"
+#include "pitch/yindiff.h"
 
 struct _aubio_pitchyin_t
 {
   fvec_t *yin;
   smpl_t tol;
   uint_t peak_pos;
+  uint_t tau_min;
+  uint_t tau_max;
+  uint_t hop_size;      /**< samples new to each window, 0 to recompute all */
+  fmat_t *blocks;       /**< difference function of each hop-sized block */
+  uint_t *block_lags;   /**< number of lags computed in each block */
+  uint_t block_pos;     /**< row of the oldest block */
+  aubio_yindiff_t diff; /**< difference kernel for the processor */
 };
 
 /** compute difference function
@@ -68,12 +77,23 @@ new_aubio_pitchyin (uint_t bufsize)
   o->yin = new_fvec (bufsize / 2);
   o->tol = 0.15;
   o->peak_pos = 0;
+  o->tau_min = 0;
+  o->tau_max = bufsize / 2 - 1;
+  o->hop_size = 0;
+  o->blocks = NULL;
+  o->block_lags = NULL;
+  o->block_pos = 0;
+  o->diff = aubio_yindiff_get_kernel ();
   return o;
 }
 
 void
 del_aubio_pitchyin (aubio_pitchyin_t * o)
 {
+  if (o->blocks) {
+    del_fmat (o->blocks);
+    AUBIO_FREE (o->block_lags);
+  }
   del_fvec (o->yin);
   AUBIO_FREE (o);
 }
@@ -95,6 +115,61 @@ aubio_pitchyin_diff (fvec_t * input, fvec_t * yin)
   }
 }
 
+/* start a new window: the oldest block left it and its row now holds the
+ * newest block, for which no lag has been computed yet */
+static void
+aubio_pitchyin_next_block (aubio_pitchyin_t * o)
+{
+  o->block_lags[o->block_pos] = 1;
+  o->block_pos = (o->block_pos + 1) % o->blocks->height;
+}
+
+/* difference function of a block at any number of lags, in groups of
+ * AUBIO_YINDIFF_LAGS for the kernel and the remaining lags in scalar */
+static void
+aubio_pitchyin_diff_lags (aubio_pitchyin_t * o, const smpl_t * input,
+    uint_t start, uint_t end, uint_t tau, uint_t n_lags, smpl_t * out)
+{
+  uint_t k = 0;
+  for (; k + AUBIO_YINDIFF_LAGS <= n_lags; k += AUBIO_YINDIFF_LAGS) {
+    o->diff (input, start, end, tau + k, AUBIO_YINDIFF_LAGS, out + k);
+  }
+  if (k < n_lags) {
+    aubio_yindiff_scalar (input, start, end, tau + k, n_lags - k, out + k);
+  }
+}
+
+/* difference function at lags tau to tau + n_lags - 1 as the sum of its
+ * hop-sized blocks. each block is computed once, on the first window
+ * needing these lags, and reused while the block stays in the window. lags
+ * are requested in increasing order, so a block only misses lags from tau
+ * on */
+static void
+aubio_pitchyin_diff_blocks (aubio_pitchyin_t * o, const smpl_t * input,
+    uint_t tau, uint_t n_lags, smpl_t * out)
+{
+  const uint_t hop_size = o->hop_size;
+  const uint_t n_blocks = o->blocks->height;
+  uint_t b, k, row, first;
+  for (k = 0; k < n_lags; k++) {
+    out[k] = 0.;
+  }
+  for (b = 0; b < n_blocks; b++) {
+    row = (o->block_pos + b) % n_blocks;
+    first = o->block_lags[row];
+    if (first < tau + n_lags) {
+      // a block left behind by the windows that stopped early catches up on
+      // all the lags it misses
+      aubio_pitchyin_diff_lags (o, input, b * hop_size, (b + 1) * hop_size,
+          first, tau + n_lags - first, o->blocks->data[row] + first);
+      o->block_lags[row] = tau + n_lags;
+    }
+    for (k = 0; k < n_lags; k++) {
+      out[k] += o->blocks->data[row][tau + k];
+    }
+  }
+}
+
 /* cumulative mean normalized difference function */
 void
 aubio_pitchyin_getcum (fvec_t * yin)
@@ -136,17 +211,32 @@ aubio_pitchyin_do (aubio_pitchyin_t * o, const fvec_t * input, fvec_t * out)
   fvec_t* yin = o->yin;
   const smpl_t *input_data = input->data;
   const uint_t length = yin->length;
+  const uint_t tau_min = o->tau_min;
+  const uint_t tau_max = o->tau_max;
+  // stop a few lags past tau_max, enough to check and interpolate its peak
+  const uint_t tau_end = MIN (tau_max + 4, length);
   smpl_t *yin_data = yin->data;
-  uint_t j, tau;
+  fvec_t tmp_slice;
+  uint_t tau, tau_next = 1, n_lags;
   sint_t period;
-  smpl_t tmp, tmp2 = 0.;
+  smpl_t tmp2 = 0.;
 
+  if (o->blocks) {
+    aubio_pitchyin_next_block (o);
+  }
   yin_data[0] = 1.;
-  for (tau = 1; tau < length; tau++) {
-    yin_data[tau] = 0.;
-    for (j = 0; j < length; j++) {
-      tmp = input_data[j] - input_data[j + tau];
-      yin_data[tau] += SQR (tmp);
+  for (tau = 1; tau < tau_end; tau++) {
+    if (tau == tau_next) {
+      // compute a group of lags ahead of the search, the kernel reads each
+      // sample once for all of them
+      n_lags = MIN (AUBIO_YINDIFF_LAGS, tau_end - tau);
+      if (o->blocks) {
+        aubio_pitchyin_diff_blocks (o, input_data, tau, n_lags, yin_data + tau);
+      } else {
+        aubio_pitchyin_diff_lags (o, input_data, 0, length, tau, n_lags,
+            yin_data + tau);
+      }
+      tau_next = tau + n_lags;
     }
     tmp2 += yin_data[tau];
     if (tmp2 != 0) {
@@ -155,17 +245,37 @@ aubio_pitchyin_do (aubio_pitchyin_t * o, const fvec_t * input, fvec_t * out)
       yin->data[tau] = 1.;
     }
     period = tau - 3;
-    if (tau > 4 && (yin_data[period] < tol) &&
+    if (tau > 4 && (uint_t)period >= tau_min && (uint_t)period <= tau_max &&
+        (yin_data[period] < tol) &&
         (yin_data[period] < yin_data[period + 1])) {
       o->peak_pos = (uint_t)period;
       out->data[0] = fvec_quadratic_peak_pos (yin, o->peak_pos);
       return;
     }
   }
-  o->peak_pos = (uint_t)fvec_min_elem (yin);
+  // use global minimum within the lag range
+  tmp_slice.data = yin_data + tau_min;
+  tmp_slice.length = tau_max + 1 - tau_min;
+  o->peak_pos = tau_min + fvec_min_elem (&tmp_slice);
+  if (o->peak_pos == tau_min || o->peak_pos == tau_max) {
+    // the minimum lies outside the lag range, no pitch and no confidence,
+    // the cumulative mean normalised difference being 1 at lag 0
+    o->peak_pos = 0;
+    out->data[0] = 0.;
+    return;
+  }
   out->data[0] = fvec_quadratic_peak_pos (yin, o->peak_pos);
 }
 
+void
+aubio_pitchyin_skip (aubio_pitchyin_t * o)
+{
+  // the blocks still in the window stay valid
+  if (o->blocks) {
+    aubio_pitchyin_next_block (o);
+  }
+}
+
 smpl_t
 aubio_pitchyin_get_confidence (aubio_pitchyin_t * o) {
   return 1. - o->yin->data[o->peak_pos];
@@ -183,3 +293,46 @@ aubio_pitchyin_get_tolerance (aubio_pitchyin_t * o)
 {
   return o->tol;
 }
+
+uint_t
+aubio_pitchyin_set_tau_range (aubio_pitchyin_t * o, uint_t tau_min,
+    uint_t tau_max)
+{
+  uint_t last = o->yin->length - 1;
+  if (tau_min > tau_max) {
+    AUBIO_ERR ("pitchyin: tau_min (%d) is larger than tau_max (%d)\n",
+        tau_min, tau_max);
+    return AUBIO_FAIL;
+  }
+  o->tau_min = MIN (tau_min, last);
+  o->tau_max = MIN (tau_max, last);
+  return AUBIO_OK;
+}
+
+uint_t
+aubio_pitchyin_set_hop_size (aubio_pitchyin_t * o, uint_t hop_size)
+{
+  uint_t length = o->yin->length;
+  uint_t b;
+  if (hop_size != 0 && (hop_size > length || length % hop_size != 0)) {
+    AUBIO_ERR ("pitchyin: hop size (%d) does not divide half the buffer"
+        " size (%d)\n", hop_size, length);
+    return AUBIO_FAIL;
+  }
+  if (o->blocks) {
+    del_fmat (o->blocks);
+    AUBIO_FREE (o->block_lags);
+    o->blocks = NULL;
+    o->block_lags = NULL;
+  }
+  o->hop_size = hop_size;
+  o->block_pos = 0;
+  if (hop_size != 0) {
+    o->blocks = new_fmat (length / hop_size, length);
+    o->block_lags = AUBIO_ARRAY (uint_t, length / hop_size);
+    for (b = 0; b < length / hop_size; b++) {
+      o->block_lags[b] = 1;
+    }
+  }
+  return AUBIO_OK;
+}
@@ -69,6 +69,18 @@ void del_aubio_pitchyin (aubio_pitchyin_t * o);
 void aubio_pitchyin_do (aubio_pitchyin_t * o, const fvec_t * samples_in, fvec_t * cands_out);
 
 
+/** skip a window without analysing it
+
+  \param o YIN pitch detection object
+
+  When a hop size was set with aubio_pitchyin_set_hop_size(), the next window
+  passed to aubio_pitchyin_do() is expected to advance by one more hop. The
+  differences already computed for the blocks remaining in the window are
+  kept. Does nothing otherwise.
+
+*/
+void aubio_pitchyin_skip (aubio_pitchyin_t * o);
+
 /** set tolerance parameter for YIN algorithm
 
   \param o YIN pitch detection object
@@ -93,6 +105,39 @@ smpl_t aubio_pitchyin_get_tolerance (aubio_pitchyin_t * o);
 */
 smpl_t aubio_pitchyin_get_confidence (aubio_pitchyin_t * o);
 
+/** restrict the range of periods searched by the YIN algorithm
+
+  \param o YIN pitch detection object
+  \param tau_min shortest period, in samples [default 0]
+  \param tau_max longest period, in samples [default buf_size/2 - 1]
+
+  The difference function is only computed up to a few samples past
+  `tau_max`, which saves computations when `tau_max` is much smaller than
+  half the buffer size. Both values are clipped to `buf_size/2 - 1`.
+
+  \return 0 if successful, non-zero otherwise
+
+*/
+uint_t aubio_pitchyin_set_tau_range (aubio_pitchyin_t * o, uint_t tau_min,
+    uint_t tau_max);
+
+/** update the difference function incrementally from one window to the next
+
+  \param o YIN pitch detection object
+  \param hop_size number of new samples in each window, or 0 to compute the
+  difference function over the whole window each time [default 0]
+
+  The difference function is kept as the sum of blocks of `hop_size`
+  samples, and only the block of the newest samples is computed for each
+  window. Consecutive calls to aubio_pitchyin_do() must then receive windows
+  advancing by `hop_size` samples, as done by aubio_pitch_do(). `hop_size`
+  must divide `buf_size/2`.
+
+  \return 0 if successful, non-zero otherwise
+
+*/
+uint_t aubio_pitchyin_set_hop_size (aubio_pitchyin_t * o, uint_t hop_size);
+
 #ifdef __cplusplus
 }
 #endif
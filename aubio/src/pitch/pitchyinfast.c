@@ -29,6 +29,7 @@
 
 #include "aubio_priv.h"
 #include "fvec.h"
+#include "fmat.h"
 #include "mathutils.h"
 #include "cvec.h"
 #include "spectral/fft.h"
@@ -39,12 +40,17 @@ struct _aubio_pitchyinfast_t
   fvec_t *yin;
   smpl_t tol;
   uint_t peak_pos;
+  uint_t tau_min;
+  uint_t tau_max;
   fvec_t *tmpdata;
   fvec_t *sqdiff;
-  fvec_t *kernel;
   fvec_t *samples_fft;
   fvec_t *kernel_fft;
   aubio_fft_t *fft;
+  uint_t hop_size;      /**< samples new to each window, 0 to transform all */
+  fmat_t *blocks;       /**< spectrum of each hop-sized block */
+  uint_t block_pos;     /**< row of the oldest block */
+  uint_t blocks_missing; /**< newest blocks of the window not transformed */
 };
 
 aubio_pitchyinfast_t *
@@ -54,37 +60,158 @@ new_aubio_pitchyinfast (uint_t bufsize)
   o->yin = new_fvec (bufsize / 2);
   o->tmpdata = new_fvec (bufsize);
   o->sqdiff = new_fvec (bufsize / 2);
-  o->kernel = new_fvec (bufsize);
   o->samples_fft = new_fvec (bufsize);
   o->kernel_fft = new_fvec (bufsize);
   o->fft = new_aubio_fft (bufsize);
   o->tol = 0.15;
   o->peak_pos = 0;
+  o->tau_min = 0;
+  o->tau_max = bufsize / 2 - 1;
+  o->hop_size = 0;
+  o->blocks = NULL;
+  o->block_pos = 0;
+  o->blocks_missing = 0;
   return o;
 }
 
 void
 del_aubio_pitchyinfast (aubio_pitchyinfast_t * o)
 {
+  if (o->blocks)
+    del_fmat (o->blocks);
   del_fvec (o->yin);
   del_fvec (o->tmpdata);
   del_fvec (o->sqdiff);
-  del_fvec (o->kernel);
   del_fvec (o->samples_fft);
   del_fvec (o->kernel_fft);
   del_aubio_fft (o->fft);
   AUBIO_FREE (o);
 }
 
+/* packed spectrum of block b of the input window, stored in the given row.
+ * the block is placed at the offset of its row rather than at its offset in
+ * the window, so that all stored spectra share the phase reference of the
+ * window in which the rows were first filled. the phases of the window
+ * spectrum and of its first half then differ from their true phases by the
+ * same shift, which cancels in the correlation, and the norm of the window
+ * spectrum is unchanged */
+static void
+aubio_pitchyinfast_block_fft (aubio_pitchyinfast_t * o, const fvec_t * input,
+    uint_t b, uint_t row)
+{
+  const uint_t hop_size = o->hop_size;
+  fvec_t spectrum;
+  uint_t j;
+  spectrum.data = o->blocks->data[row];
+  spectrum.length = o->blocks->length;
+  fvec_zeros (&spectrum);
+  for (j = 0; j < hop_size; j++) {
+    spectrum.data[row * hop_size + j] = input->data[b * hop_size + j];
+  }
+  aubio_fft_do_packed (o->fft, &spectrum);
+}
+
+/* sum the block spectra into the spectrum of the window and of its first
+ * half */
+static void
+aubio_pitchyinfast_sum_blocks (aubio_pitchyinfast_t * o)
+{
+  const uint_t n_blocks = o->blocks->height;
+  const uint_t length = o->blocks->length;
+  smpl_t *samples_fft = o->samples_fft->data;
+  smpl_t *head_fft = o->kernel_fft->data;
+  const smpl_t *block;
+  uint_t b, k;
+  fvec_zeros (o->samples_fft);
+  fvec_zeros (o->kernel_fft);
+  for (b = 0; b < n_blocks; b++) {
+    block = o->blocks->data[(o->block_pos + b) % n_blocks];
+    for (k = 0; k < length; k++) {
+      samples_fft[k] += block[k];
+    }
+    if (b < n_blocks / 2) {
+      for (k = 0; k < length; k++) {
+        head_fft[k] += block[k];
+      }
+    }
+  }
+}
+
+/* update the spectrum of the window and of its first half, transforming
+ * only the block of the newest samples */
+static void
+aubio_pitchyinfast_update_spectra (aubio_pitchyinfast_t * o,
+    const fvec_t * input)
+{
+  const uint_t n_blocks = o->blocks->height;
+  const uint_t length = o->blocks->length;
+  smpl_t *samples_fft = o->samples_fft->data;
+  smpl_t *head_fft = o->kernel_fft->data;
+  const smpl_t *oldest, *middle;
+  uint_t b, k, old;
+
+  if (o->blocks_missing > 0) {
+    // first window, or windows were skipped: transform the blocks missing
+    // at the end of the window
+    aubio_pitchyinfast_skip (o);
+    for (b = n_blocks - o->blocks_missing; b < n_blocks; b++) {
+      aubio_pitchyinfast_block_fft (o, input, b, (o->block_pos + b) % n_blocks);
+    }
+    o->blocks_missing = 0;
+    aubio_pitchyinfast_sum_blocks (o);
+    return;
+  }
+
+  // the oldest block left the window, and the one in the middle moved to
+  // its first half
+  old = o->block_pos;
+  oldest = o->blocks->data[old];
+  middle = o->blocks->data[(old + n_blocks / 2) % n_blocks];
+  for (k = 0; k < length; k++) {
+    samples_fft[k] -= oldest[k];
+    head_fft[k] += middle[k] - oldest[k];
+  }
+
+  // the newest block takes the row of the oldest one
+  aubio_pitchyinfast_block_fft (o, input, n_blocks - 1, old);
+  o->block_pos = (old + 1) % n_blocks;
+
+  if (o->block_pos == 0) {
+    // sum again once per turn of the rows, so that rounding errors of the
+    // running sums do not accumulate
+    aubio_pitchyinfast_sum_blocks (o);
+  } else {
+    for (k = 0; k < length; k++) {
+      samples_fft[k] += o->blocks->data[old][k];
+    }
+  }
+}
+
 /* all the above in one */
 void
 aubio_pitchyinfast_do (aubio_pitchyinfast_t * o, const fvec_t * input, fvec_t * out)
+{
+  fvec_t *squares = o->tmpdata;
+  fvec_t head;
+  fvec_weighted_copy (input, input, squares);
+  head.data = squares->data;
+  head.length = o->yin->length;
+  aubio_pitchyinfast_do_squared (o, input, squares, fvec_sum (&head), out);
+}
+
+void
+aubio_pitchyinfast_do_squared (aubio_pitchyinfast_t * o, const fvec_t * input,
+    const fvec_t * squares, smpl_t head_energy, fvec_t * out)
 {
   const smpl_t tol = o->tol;
   fvec_t* yin = o->yin;
   const uint_t length = yin->length;
   uint_t B = o->tmpdata->length;
   uint_t W = o->yin->length; // B / 2
+  const uint_t tau_min = o->tau_min;
+  const uint_t tau_max = o->tau_max;
+  // stop a few lags past tau_max, enough to check and interpolate its peak
+  const uint_t tau_end = MIN (tau_max + 4, length);
   fvec_t tmp_slice, kernel_ptr;
   uint_t tau;
   sint_t period;
@@ -92,8 +219,6 @@ aubio_pitchyinfast_do (aubio_pitchyinfast_t * o, const fvec_t * input, fvec_t *
 
   // compute r_t(0) + r_t+tau(0)
   {
-    fvec_t *squares = o->tmpdata;
-    fvec_weighted_copy(input, input, squares);
 #if 0
     for (tau = 0; tau < W; tau++) {
       tmp_slice.data = squares->data + tau;
@@ -101,55 +226,54 @@ aubio_pitchyinfast_do (aubio_pitchyinfast_t * o, const fvec_t * input, fvec_t *
       o->sqdiff->data[tau] = fvec_sum(&tmp_slice);
     }
 #else
-    tmp_slice.data = squares->data;
-    tmp_slice.length = W;
-    o->sqdiff->data[0] = fvec_sum(&tmp_slice);
-    for (tau = 1; tau < W; tau++) {
+    o->sqdiff->data[0] = head_energy;
+    for (tau = 1; tau < tau_end; tau++) {
       o->sqdiff->data[tau] = o->sqdiff->data[tau-1];
       o->sqdiff->data[tau] -= squares->data[tau-1];
       o->sqdiff->data[tau] += squares->data[W+tau-1];
     }
 #endif
-    fvec_add(o->sqdiff, o->sqdiff->data[0]);
+    tmp_slice.data = o->sqdiff->data;
+    tmp_slice.length = tau_end;
+    fvec_add(&tmp_slice, o->sqdiff->data[0]);
   }
-  // compute r_t(tau) = -2.*ifft(fft(samples)*fft(samples[W-1::-1]))
+  // compute r_t(tau) = ifft(conj(fft(samples[:W])) * fft(samples))
   {
-    fvec_t *compmul = o->tmpdata;
-    fvec_t *rt_of_tau = o->samples_fft;
-    aubio_fft_do_complex(o->fft, input, o->samples_fft);
-    // build kernel, take a copy of first half of samples
-    tmp_slice.data = input->data;
-    tmp_slice.length = W;
-    kernel_ptr.data = o->kernel->data + 1;
-    kernel_ptr.length = W;
-    fvec_copy(&tmp_slice, &kernel_ptr);
-    // reverse them
-    fvec_rev(&kernel_ptr);
-    // compute fft(kernel)
-    aubio_fft_do_complex(o->fft, o->kernel, o->kernel_fft);
-    // compute complex product
-    compmul->data[0]  = o->kernel_fft->data[0] * o->samples_fft->data[0];
-    for (tau = 1; tau < W; tau++) {
-      compmul->data[tau]    = o->kernel_fft->data[tau] * o->samples_fft->data[tau];
-      compmul->data[tau]   -= o->kernel_fft->data[B-tau] * o->samples_fft->data[B-tau];
-    }
-    compmul->data[W]    = o->kernel_fft->data[W] * o->samples_fft->data[W];
-    for (tau = 1; tau < W; tau++) {
-      compmul->data[B-tau]  = o->kernel_fft->data[B-tau] * o->samples_fft->data[tau];
-      compmul->data[B-tau] += o->kernel_fft->data[tau] * o->samples_fft->data[B-tau];
+    // product and inverse transform in place, so that samples_fft is kept
+    // for aubio_pitchyinfast_get_spectrum
+    fvec_t *rt_of_tau = o->tmpdata;
+    if (o->blocks) {
+      aubio_pitchyinfast_update_spectra (o, input);
+    } else {
+      fvec_copy(input, o->samples_fft);
+      aubio_fft_do_packed(o->fft, o->samples_fft);
+      // build kernel, a copy of the first half of samples zero padded to
+      // the buffer size
+      tmp_slice.data = input->data;
+      tmp_slice.length = W;
+      kernel_ptr.data = o->kernel_fft->data;
+      kernel_ptr.length = W;
+      fvec_copy(&tmp_slice, &kernel_ptr);
+      kernel_ptr.data = o->kernel_fft->data + W;
+      kernel_ptr.length = B - W;
+      fvec_zeros(&kernel_ptr);
+      // compute fft(kernel)
+      aubio_fft_do_packed(o->fft, o->kernel_fft);
     }
+    // compute complex product with the conjugate of fft(kernel)
+    aubio_fft_packed_mul_conj(o->kernel_fft, o->samples_fft, rt_of_tau);
     // compute inverse fft
-    aubio_fft_rdo_complex(o->fft, compmul, rt_of_tau);
-    // compute square difference r_t(tau) = sqdiff - 2 * r_t_tau[W-1:-1]
-    for (tau = 0; tau < W; tau++) {
-      yin->data[tau] = o->sqdiff->data[tau] - 2. * rt_of_tau->data[tau+W];
+    aubio_fft_rdo_packed(o->fft, rt_of_tau);
+    // compute square difference r_t(tau) = sqdiff - 2 * r_t_tau[:W]
+    for (tau = 0; tau < tau_end; tau++) {
+      yin->data[tau] = o->sqdiff->data[tau] - 2. * rt_of_tau->data[tau];
     }
   }
 
   // now build yin and look for first minimum
   fvec_zeros(out);
   yin->data[0] = 1.;
-  for (tau = 1; tau < length; tau++) {
+  for (tau = 1; tau < tau_end; tau++) {
     tmp2 += yin->data[tau];
     if (tmp2 != 0) {
       yin->data[tau] *= tau / tmp2;
@@ -157,18 +281,34 @@ aubio_pitchyinfast_do (aubio_pitchyinfast_t * o, const fvec_t * input, fvec_t *
       yin->data[tau] = 1.;
     }
     period = tau - 3;
-    if (tau > 4 && (yin->data[period] < tol) &&
+    if (tau > 4 && (uint_t)period >= tau_min && (uint_t)period <= tau_max &&
+        (yin->data[period] < tol) &&
         (yin->data[period] < yin->data[period + 1])) {
       o->peak_pos = (uint_t)period;
       out->data[0] = fvec_quadratic_peak_pos (yin, o->peak_pos);
       return;
     }
   }
-  // use global minimum 
-  o->peak_pos = (uint_t)fvec_min_elem (yin);
+  // use global minimum within the lag range
+  tmp_slice.data = yin->data + tau_min;
+  tmp_slice.length = tau_max + 1 - tau_min;
+  o->peak_pos = tau_min + fvec_min_elem (&tmp_slice);
+  if (o->peak_pos == tau_min || o->peak_pos == tau_max) {
+    // the minimum lies outside the lag range, no pitch and no confidence,
+    // the cumulative mean normalised difference being 1 at lag 0
+    o->peak_pos = 0;
+    out->data[0] = 0.;
+    return;
+  }
   out->data[0] = fvec_quadratic_peak_pos (yin, o->peak_pos);
 }
 
+void
+aubio_pitchyinfast_get_spectrum (aubio_pitchyinfast_t * o, cvec_t * spectrum)
+{
+  aubio_fft_packed_get_norm (o->samples_fft, spectrum);
+}
+
 smpl_t
 aubio_pitchyinfast_get_confidence (aubio_pitchyinfast_t * o) {
   return 1. - o->yin->data[o->peak_pos];
@@ -186,3 +326,52 @@ aubio_pitchyinfast_get_tolerance (aubio_pitchyinfast_t * o)
 {
   return o->tol;
 }
+
+uint_t
+aubio_pitchyinfast_set_tau_range (aubio_pitchyinfast_t * o, uint_t tau_min,
+    uint_t tau_max)
+{
+  uint_t last = o->yin->length - 1;
+  if (tau_min > tau_max) {
+    AUBIO_ERR ("pitchyinfast: tau_min (%d) is larger than tau_max (%d)\n",
+        tau_min, tau_max);
+    return AUBIO_FAIL;
+  }
+  o->tau_min = MIN (tau_min, last);
+  o->tau_max = MIN (tau_max, last);
+  return AUBIO_OK;
+}
+
+void
+aubio_pitchyinfast_skip (aubio_pitchyinfast_t * o)
+{
+  // the row of the oldest block is left for the newest one, the blocks
+  // still in the window stay valid
+  if (o->blocks) {
+    o->block_pos = (o->block_pos + 1) % o->blocks->height;
+    o->blocks_missing = MIN (o->blocks_missing + 1, o->blocks->height);
+  }
+}
+
+uint_t
+aubio_pitchyinfast_set_hop_size (aubio_pitchyinfast_t * o, uint_t hop_size)
+{
+  uint_t length = o->yin->length;
+  if (hop_size != 0 && (hop_size > length || length % hop_size != 0)) {
+    AUBIO_ERR ("pitchyinfast: hop size (%d) does not divide half the buffer"
+        " size (%d)\n", hop_size, length);
+    return AUBIO_FAIL;
+  }
+  if (o->blocks) {
+    del_fmat (o->blocks);
+    o->blocks = NULL;
+  }
+  o->hop_size = hop_size;
+  o->block_pos = 0;
+  o->blocks_missing = 0;
+  if (hop_size != 0) {
+    o->blocks = new_fmat (2 * length / hop_size, 2 * length);
+    o->blocks_missing = o->blocks->height;
+  }
+  return AUBIO_OK;
+}
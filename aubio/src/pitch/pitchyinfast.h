@@ -69,6 +69,22 @@ void del_aubio_pitchyinfast (aubio_pitchyinfast_t * o);
 */
 void aubio_pitchyinfast_do (aubio_pitchyinfast_t * o, const fvec_t * samples_in, fvec_t * cands_out);
 
+/** execute pitch detection on an input buffer with known squared samples
+
+  \param o pitch detection object as returned by new_aubio_pitchyinfast()
+  \param samples_in input signal vector (length as specified at creation time)
+  \param squares squares of `samples_in`
+  \param head_energy sum of the first `buf_size/2` elements of `squares`
+  \param cands_out pitch period candidates, in samples
+
+  Same as aubio_pitchyinfast_do(), for callers that keep the energy of the
+  sliding window up to date, as done by aubio_pitch_do().
+
+*/
+void aubio_pitchyinfast_do_squared (aubio_pitchyinfast_t * o,
+    const fvec_t * samples_in, const fvec_t * squares, smpl_t head_energy,
+    fvec_t * cands_out);
+
 
 /** set tolerance parameter for YIN algorithm
 
@@ -94,6 +110,67 @@ smpl_t aubio_pitchyinfast_get_tolerance (aubio_pitchyinfast_t * o);
 */
 smpl_t aubio_pitchyinfast_get_confidence (aubio_pitchyinfast_t * o);
 
+/** restrict the range of periods searched by the YIN algorithm
+
+  \param o YIN pitch detection object
+  \param tau_min shortest period, in samples [default 0]
+  \param tau_max longest period, in samples [default buf_size/2 - 1]
+
+  The difference function is only computed up to a few samples past
+  `tau_max`, which saves computations when `tau_max` is much smaller than
+  half the buffer size. Both values are clipped to `buf_size/2 - 1`.
+
+  \return 0 if successful, non-zero otherwise
+
+*/
+uint_t aubio_pitchyinfast_set_tau_range (aubio_pitchyinfast_t * o, uint_t tau_min,
+    uint_t tau_max);
+
+/** transform only the newest samples of each window
+
+  \param o YIN pitch detection object
+  \param hop_size number of new samples in each window, or 0 to transform
+  the whole window each time [default 0]
+
+  The correlation of the window with its first half is computed from the
+  spectra of both. When `hop_size` is set, these spectra are kept as sums of
+  the spectra of blocks of `hop_size` samples, and only the block of the
+  newest samples is transformed for each window, instead of the window and
+  its first half. Consecutive calls to aubio_pitchyinfast_do() must then
+  receive windows advancing by `hop_size` samples, as done by
+  aubio_pitch_do(). `hop_size` must divide `buf_size/2`.
+
+  \return 0 if successful, non-zero otherwise
+
+*/
+uint_t aubio_pitchyinfast_set_hop_size (aubio_pitchyinfast_t * o,
+    uint_t hop_size);
+
+/** skip a window without analysing it
+
+  \param o YIN pitch detection object
+
+  When a hop size was set with aubio_pitchyinfast_set_hop_size(), the next
+  window passed to aubio_pitchyinfast_do() is expected to advance by one more
+  hop. Only the blocks that entered the window since the last analysed one
+  are then transformed, up to the whole window. Does nothing otherwise.
+
+*/
+void aubio_pitchyinfast_skip (aubio_pitchyinfast_t * o);
+
+/** get the magnitude spectrum of the last analysed buffer
+
+  \param o YIN pitch detection object
+  \param spectrum output spectrum, of size `buf_size/2+1`, only the norm is
+  set
+
+  The spectrum is the one computed by aubio_pitchyinfast_do(), no window is
+  applied to the input buffer.
+
+*/
+void aubio_pitchyinfast_get_spectrum (aubio_pitchyinfast_t * o,
+    cvec_t * spectrum);
+
 #ifdef __cplusplus
 }
 #endif
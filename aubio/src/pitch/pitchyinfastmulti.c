@@ -0,0 +1,473 @@
+/*
+  Copyright (C) 2026 the audio-to-cv-pitch-lv2 contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/* Multichannel version of pitchyinfast.c. The correlation of each channel is
+ * computed as in pitchyinfast.c, with one aubio_fft_t shared by all channels
+ * and, when a hop size is set, the spectra of each window kept as sums of
+ * the spectra of its blocks. The time domain part of the algorithm then runs
+ * on groups of YINFAST_MULTI_LANES channels, with the yin function stored
+ * with channels interleaved, element [tau][lane] at tau * YINFAST_MULTI_LANES
+ * + lane, so that the innermost loops run over the lanes of a group and get
+ * vectorised. The square sums, the square difference and its cumulative mean
+ * normalisation are computed in a single pass over the lags, which stops as
+ * soon as every lane of the group found its first minimum. */
+
+#include "aubio_priv.h"
+#include "fvec.h"
+#include "fmat.h"
+#include "mathutils.h"
+#include "cvec.h"
+#include "spectral/fft.h"
+#include "pitch/pitchyinfastmulti.h"
+
+/** number of channels processed together, as one vector */
+#define YINFAST_MULTI_LANES 4
+
+/** shortcut to loop over the lanes of a group */
+#define LANES(c) for (c = 0; c < YINFAST_MULTI_LANES; c++)
+
+/** number of lags whose inputs are interleaved at once */
+#define YINFAST_MULTI_CHUNK 32
+
+struct _aubio_pitchyinfast_multi_t
+{
+  uint_t channels;      /**< number of input channels */
+  uint_t bufsize;       /**< input buffer size */
+  smpl_t tol;           /**< yin tolerance */
+  uint_t *peak_pos;     /**< selected peak position, per channel */
+  smpl_t *confidence;   /**< confidence of the selected peak, per channel */
+  uint_t *skipped;      /**< channels to skip on the next run */
+  aubio_fft_t *fft;     /**< transform of bufsize, shared by all channels */
+  fmat_t *samples_fft;  /**< packed spectrum of each window */
+  fmat_t *kernel_fft;   /**< packed spectrum of the first half of each window */
+  fmat_t *rt;           /**< correlation of each lane of a group */
+  smpl_t *yin;          /**< yin function, [bufsize/2][lanes] */
+  uint_t hop_size;      /**< samples new to each window, 0 to transform all */
+  fmat_t *blocks;       /**< spectrum of each hop-sized block, per channel */
+  uint_t n_blocks;      /**< number of blocks in a window */
+  uint_t block_pos;     /**< row of the oldest block */
+  uint_t *blocks_missing; /**< newest blocks not transformed, per channel */
+};
+
+aubio_pitchyinfast_multi_t *
+new_aubio_pitchyinfast_multi (uint_t bufsize, uint_t channels)
+{
+  aubio_pitchyinfast_multi_t *o = AUBIO_NEW (aubio_pitchyinfast_multi_t);
+  if ((sint_t)channels < 1 || channels > AUBIO_MAX_CHANNELS) {
+    AUBIO_ERR ("pitchyinfast_multi: got %d channels, but can not be < 1"
+        " or > %d\n", channels, AUBIO_MAX_CHANNELS);
+    goto beach;
+  }
+  if ((sint_t)bufsize < 8 || bufsize % 2 != 0) {
+    AUBIO_ERR ("pitchyinfast_multi: can only create with even sizes >= 8,"
+        " requested %d\n", bufsize);
+    goto beach;
+  }
+  o->fft = new_aubio_fft (bufsize);
+  if (!o->fft) goto beach;
+  o->channels = channels;
+  o->bufsize = bufsize;
+  o->peak_pos = AUBIO_ARRAY (uint_t, channels);
+  o->confidence = AUBIO_ARRAY (smpl_t, channels);
+  o->skipped = AUBIO_ARRAY (uint_t, channels);
+  o->samples_fft = new_fmat (channels, bufsize);
+  o->kernel_fft = new_fmat (channels, bufsize);
+  o->rt = new_fmat (YINFAST_MULTI_LANES, bufsize);
+  o->yin = AUBIO_ARRAY (smpl_t, bufsize / 2 * YINFAST_MULTI_LANES);
+  o->blocks_missing = AUBIO_ARRAY (uint_t, channels);
+  o->tol = 0.15;
+  return o;
+
+beach:
+  AUBIO_FREE (o);
+  return NULL;
+}
+
+void
+del_aubio_pitchyinfast_multi (aubio_pitchyinfast_multi_t * o)
+{
+  if (o->blocks)
+    del_fmat (o->blocks);
+  del_aubio_fft (o->fft);
+  del_fmat (o->samples_fft);
+  del_fmat (o->kernel_fft);
+  del_fmat (o->rt);
+  AUBIO_FREE (o->peak_pos);
+  AUBIO_FREE (o->confidence);
+  AUBIO_FREE (o->skipped);
+  AUBIO_FREE (o->yin);
+  AUBIO_FREE (o->blocks_missing);
+  AUBIO_FREE (o);
+}
+
+/* packed spectrum of block b of the window x of channel c, stored in the
+ * given row of the channel, placed at the offset of the row as in
+ * pitchyinfast.c */
+static void
+aubio_pitchyinfast_multi_block_fft (aubio_pitchyinfast_multi_t * o,
+    const smpl_t * x, uint_t c, uint_t b, uint_t row)
+{
+  const uint_t hop_size = o->hop_size;
+  fvec_t spectrum;
+  uint_t j;
+  spectrum.data = o->blocks->data[c * o->n_blocks + row];
+  spectrum.length = o->bufsize;
+  fvec_zeros (&spectrum);
+  for (j = 0; j < hop_size; j++) {
+    spectrum.data[row * hop_size + j] = x[b * hop_size + j];
+  }
+  aubio_fft_do_packed (o->fft, &spectrum);
+}
+
+/* sum the block spectra of channel c, the oldest one in the given row, into
+ * the spectrum of its window and of the first half of its window */
+static void
+aubio_pitchyinfast_multi_sum_blocks (aubio_pitchyinfast_multi_t * o, uint_t c,
+    uint_t oldest)
+{
+  const uint_t n_blocks = o->n_blocks;
+  const uint_t length = o->bufsize;
+  smpl_t *samples_fft = o->samples_fft->data[c];
+  smpl_t *head_fft = o->kernel_fft->data[c];
+  smpl_t **blocks = o->blocks->data + c * n_blocks;
+  const smpl_t *block;
+  uint_t b, k;
+  for (k = 0; k < length; k++) {
+    samples_fft[k] = 0.;
+    head_fft[k] = 0.;
+  }
+  for (b = 0; b < n_blocks / 2; b++) {
+    block = blocks[(oldest + b) % n_blocks];
+    for (k = 0; k < length; k++) {
+      samples_fft[k] += block[k];
+      head_fft[k] += block[k];
+    }
+  }
+  for (; b < n_blocks; b++) {
+    block = blocks[(oldest + b) % n_blocks];
+    for (k = 0; k < length; k++) {
+      samples_fft[k] += block[k];
+    }
+  }
+}
+
+/* update the spectra of channel c, transforming only the block of the newest
+ * samples. the row of the oldest block, o->block_pos, is shared by all the
+ * channels, and only moved once all of them are updated */
+static void
+aubio_pitchyinfast_multi_update_spectra (aubio_pitchyinfast_multi_t * o,
+    const smpl_t * x, uint_t c)
+{
+  const uint_t n_blocks = o->n_blocks;
+  const uint_t length = o->bufsize;
+  const uint_t old = o->block_pos;
+  const uint_t next = (old + 1) % n_blocks;
+  smpl_t *samples_fft = o->samples_fft->data[c];
+  smpl_t *head_fft = o->kernel_fft->data[c];
+  smpl_t **blocks = o->blocks->data + c * n_blocks;
+  const smpl_t *oldest = blocks[old];
+  const smpl_t *middle = blocks[(old + n_blocks / 2) % n_blocks];
+  uint_t b, k;
+
+  if (o->blocks_missing[c] > 0) {
+    // first window, or windows were skipped: transform the blocks missing
+    // at the end of the window, including the newest one, the window now
+    // starting at the next row
+    o->blocks_missing[c] = MIN (o->blocks_missing[c] + 1, n_blocks);
+    for (b = n_blocks - o->blocks_missing[c]; b < n_blocks; b++) {
+      aubio_pitchyinfast_multi_block_fft (o, x, c, b, (next + b) % n_blocks);
+    }
+    o->blocks_missing[c] = 0;
+    aubio_pitchyinfast_multi_sum_blocks (o, c, next);
+    return;
+  }
+
+  // the oldest block left the window, and the one in the middle moved to
+  // its first half
+  for (k = 0; k < length; k++) {
+    samples_fft[k] -= oldest[k];
+    head_fft[k] += middle[k] - oldest[k];
+  }
+
+  // the newest block takes the row of the oldest one
+  aubio_pitchyinfast_multi_block_fft (o, x, c, n_blocks - 1, old);
+
+  if (next == 0) {
+    // sum again once per turn of the rows, so that rounding errors of the
+    // running sums do not accumulate
+    aubio_pitchyinfast_multi_sum_blocks (o, c, next);
+  } else {
+    for (k = 0; k < length; k++) {
+      samples_fft[k] += oldest[k];
+    }
+  }
+}
+
+/* compute r_t(tau) = ifft(conj(fft(x[:W])) * fft(x)) of channel c in rt */
+static void
+aubio_pitchyinfast_multi_correlate (aubio_pitchyinfast_multi_t * o,
+    const smpl_t * x, uint_t c, fvec_t * rt)
+{
+  const uint_t B = o->bufsize;
+  const uint_t W = B / 2;
+  fvec_t samples_fft, kernel_fft;
+  uint_t j;
+  samples_fft.data = o->samples_fft->data[c];
+  samples_fft.length = B;
+  kernel_fft.data = o->kernel_fft->data[c];
+  kernel_fft.length = B;
+  if (o->blocks) {
+    aubio_pitchyinfast_multi_update_spectra (o, x, c);
+  } else {
+    for (j = 0; j < B; j++) {
+      samples_fft.data[j] = x[j];
+    }
+    aubio_fft_do_packed (o->fft, &samples_fft);
+    for (j = 0; j < W; j++) {
+      kernel_fft.data[j] = x[j];
+      kernel_fft.data[W + j] = 0.;
+    }
+    aubio_fft_do_packed (o->fft, &kernel_fft);
+  }
+  aubio_fft_packed_mul_conj (&kernel_fft, &samples_fft, rt);
+  aubio_fft_rdo_packed (o->fft, rt);
+}
+
+/* lags [start, end) of the square sums, square difference and cumulative
+ * mean normalisation on all lanes, from the change of the square sums and
+ * the correlation at each lag, interleaved */
+static void
+aubio_pitchyinfast_multi_cmndf (smpl_t * restrict yin,
+    smpl_t * restrict sqdiff, smpl_t * restrict sum,
+    const smpl_t * restrict step, const smpl_t * restrict head,
+    const smpl_t * restrict rt, uint_t start, uint_t end)
+{
+  const uint_t L = YINFAST_MULTI_LANES;
+  const smpl_t one = 1., two = 2.;
+  uint_t c, tau;
+  for (tau = start; tau < end; tau++) {
+    const smpl_t lag = tau;
+    const uint_t i = (tau - start) * L;
+    LANES(c) {
+      smpl_t d;
+      sqdiff[c] += step[i + c];
+      d = head[c] + sqdiff[c] - two * rt[i + c];
+      sum[c] += d;
+      yin[tau * L + c] = (sum[c] != 0) ? d * lag / sum[c] : one;
+    }
+  }
+}
+
+/* 3 point quadratic interpolation of the interleaved yin function */
+static smpl_t
+aubio_pitchyinfast_multi_peak_pos (const smpl_t * yin, uint_t length,
+    uint_t pos)
+{
+  const uint_t L = YINFAST_MULTI_LANES;
+  smpl_t s0, s1, s2;
+  if (pos == 0 || pos == length - 1) return pos;
+  s0 = yin[(pos - 1) * L];
+  s1 = yin[pos * L];
+  s2 = yin[(pos + 1) * L];
+  return pos + .5 * (s0 - s2) / (s0 - 2. * s1 + s2);
+}
+
+/* run the detection on channels [first, first + count) */
+static void
+aubio_pitchyinfast_multi_do_group (aubio_pitchyinfast_multi_t * o,
+    const fmat_t * input, uint_t first, uint_t count, fvec_t * out)
+{
+  const smpl_t tol = o->tol;
+  const uint_t L = YINFAST_MULTI_LANES;
+  const uint_t W = o->bufsize / 2;
+  smpl_t *yin = o->yin;
+  const smpl_t *x[YINFAST_MULTI_LANES];
+  const smpl_t *rt[YINFAST_MULTI_LANES];
+  smpl_t head[YINFAST_MULTI_LANES];
+  smpl_t sqdiff[YINFAST_MULTI_LANES];
+  smpl_t sum[YINFAST_MULTI_LANES];
+  smpl_t step[YINFAST_MULTI_CHUNK * YINFAST_MULTI_LANES];
+  smpl_t rt_tau[YINFAST_MULTI_CHUNK * YINFAST_MULTI_LANES];
+  uint_t peak_pos[YINFAST_MULTI_LANES];
+  uint_t c, j, tau, start, end, remaining = 0;
+  fvec_t rt_lane;
+
+  // correlation of each channel, the skipped channels and the unused lanes
+  // of the last group are not analysed, and are marked as already found
+  rt_lane.length = o->bufsize;
+  LANES(c) {
+    const uint_t ch = first + MIN(c, count - 1);
+    x[c] = input->data[ch];
+    rt[c] = o->rt->data[c];
+    peak_pos[c] = 1;
+    if (c < count && !o->skipped[ch]) {
+      rt_lane.data = o->rt->data[c];
+      aubio_pitchyinfast_multi_correlate (o, x[c], ch, &rt_lane);
+      peak_pos[c] = 0;
+      remaining++;
+    } else if (c < count && o->blocks) {
+      // the blocks that entered the window meanwhile are transformed when
+      // the channel is analysed again
+      o->blocks_missing[ch] = MIN (o->blocks_missing[ch] + 1, o->n_blocks);
+    }
+  }
+
+  // r_t(0) + r_t+tau(0), with r_t(0) the energy of the first half. the
+  // lanes not analysed still go through the difference, but are never read
+  LANES(c) {
+    head[c] = 0.;
+    if (peak_pos[c] == 0) {
+      for (j = 0; j < W; j++) {
+        head[c] += x[c][j] * x[c][j];
+      }
+    }
+    sqdiff[c] = head[c];
+    sum[c] = 0.;
+    yin[c] = 1.;
+  }
+
+  // square difference r_t(0) + r_t+tau(0) - 2 * r_t(tau), then cumulative
+  // mean normalized difference function, stopping as soon as every lane
+  // found its first minimum. the inputs of a chunk of lags are first
+  // interleaved, each lane reading its own rows contiguously
+  for (start = 1; start < W && remaining > 0; start = end) {
+    end = MIN (start + YINFAST_MULTI_CHUNK, W);
+    LANES(c) {
+      const smpl_t *leaving = x[c] - 1, *entering = x[c] + W - 1;
+      for (tau = start; tau < end; tau++) {
+        step[(tau - start) * L + c] = entering[tau] * entering[tau]
+          - leaving[tau] * leaving[tau];
+        rt_tau[(tau - start) * L + c] = rt[c][tau];
+      }
+    }
+    aubio_pitchyinfast_multi_cmndf (yin, sqdiff, sum, step, head, rt_tau,
+        start, end);
+    for (tau = MAX (start, 5); tau < end && remaining > 0; tau++) {
+      const smpl_t *cand = yin + (tau - 3) * L;
+      const smpl_t *next = cand + L;
+      LANES(c) {
+        if (peak_pos[c] == 0 && cand[c] < tol && cand[c] < next[c]) {
+          peak_pos[c] = tau - 3;
+          remaining--;
+        }
+      }
+    }
+  }
+
+  for (c = 0; c < count; c++) {
+    const smpl_t *y = yin + c;
+    if (o->skipped[first + c]) {
+      o->skipped[first + c] = 0;
+      o->peak_pos[first + c] = 0;
+      o->confidence[first + c] = 0.;
+      out->data[first + c] = 0.;
+      continue;
+    }
+    if (peak_pos[c] == 0) {
+      // use global minimum
+      smpl_t tmp = y[0];
+      for (tau = 0; tau < W; tau++) {
+        peak_pos[c] = (tmp < y[tau * L]) ? peak_pos[c] : tau;
+        tmp = (tmp < y[tau * L]) ? tmp : y[tau * L];
+      }
+    }
+    if (peak_pos[c] == W - 1) {
+      // the minimum lies past the last lag, no pitch
+      peak_pos[c] = 0;
+    }
+    o->peak_pos[first + c] = peak_pos[c];
+    o->confidence[first + c] = 1. - y[peak_pos[c] * L];
+    out->data[first + c] = aubio_pitchyinfast_multi_peak_pos (y, W,
+        peak_pos[c]);
+  }
+}
+
+void
+aubio_pitchyinfast_multi_do (aubio_pitchyinfast_multi_t * o,
+    const fmat_t * input, fvec_t * out)
+{
+  uint_t first;
+  for (first = 0; first < o->channels; first += YINFAST_MULTI_LANES) {
+    aubio_pitchyinfast_multi_do_group (o, input, first,
+        MIN(YINFAST_MULTI_LANES, o->channels - first), out);
+  }
+  // the row of the oldest block is left for the newest one
+  if (o->blocks) {
+    o->block_pos = (o->block_pos + 1) % o->n_blocks;
+  }
+}
+
+void
+aubio_pitchyinfast_multi_skip (aubio_pitchyinfast_multi_t * o,
+    uint_t channel)
+{
+  if (channel < o->channels) {
+    o->skipped[channel] = 1;
+  }
+}
+
+smpl_t
+aubio_pitchyinfast_multi_get_confidence (aubio_pitchyinfast_multi_t * o,
+    uint_t channel)
+{
+  if (channel >= o->channels) return 0.;
+  return o->confidence[channel];
+}
+
+uint_t
+aubio_pitchyinfast_multi_set_tolerance (aubio_pitchyinfast_multi_t * o,
+    smpl_t tol)
+{
+  o->tol = tol;
+  return 0;
+}
+
+smpl_t
+aubio_pitchyinfast_multi_get_tolerance (aubio_pitchyinfast_multi_t * o)
+{
+  return o->tol;
+}
+
+uint_t
+aubio_pitchyinfast_multi_set_hop_size (aubio_pitchyinfast_multi_t * o,
+    uint_t hop_size)
+{
+  uint_t length = o->bufsize / 2, c;
+  if (hop_size != 0 && (hop_size > length || length % hop_size != 0)) {
+    AUBIO_ERR ("pitchyinfast_multi: hop size (%d) does not divide half the"
+        " buffer size (%d)\n", hop_size, length);
+    return AUBIO_FAIL;
+  }
+  if (o->blocks) {
+    del_fmat (o->blocks);
+    o->blocks = NULL;
+  }
+  o->hop_size = hop_size;
+  o->n_blocks = 0;
+  o->block_pos = 0;
+  if (hop_size != 0) {
+    o->n_blocks = 2 * length / hop_size;
+    o->blocks = new_fmat (o->channels * o->n_blocks, o->bufsize);
+  }
+  for (c = 0; c < o->channels; c++) {
+    o->blocks_missing[c] = o->n_blocks;
+  }
+  return AUBIO_OK;
+}
@@ -0,0 +1,133 @@
+/*
+  Copyright (C) 2026 the audio-to-cv-pitch-lv2 contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/** \file
+
+  Multichannel pitch detection using YIN algorithm (fast implementation)
+
+  This object runs the same computation as ::aubio_pitchyinfast_t on several
+  channels at once. The correlation of each channel is computed with one
+  Fourier transform object shared by all channels, then the time domain part
+  of the algorithm processes channels in groups of four, stored interleaved,
+  so that it runs on all channels of a group in the same loop iteration and
+  can be vectorised across channels.
+
+  \sa pitchyinfast.h
+
+*/
+
+#ifndef AUBIO_PITCHYINFASTMULTI_H
+#define AUBIO_PITCHYINFASTMULTI_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** multichannel pitch detection object */
+typedef struct _aubio_pitchyinfast_multi_t aubio_pitchyinfast_multi_t;
+
+/** creation of the multichannel pitch detection object
+
+  \param buf_size size of the input buffer to analyse
+  \param channels number of channels to analyse
+
+*/
+aubio_pitchyinfast_multi_t *new_aubio_pitchyinfast_multi (uint_t buf_size,
+    uint_t channels);
+
+/** deletion of the multichannel pitch detection object
+
+  \param o pitch detection object as returned by new_aubio_pitchyinfast_multi()
+
+*/
+void del_aubio_pitchyinfast_multi (aubio_pitchyinfast_multi_t * o);
+
+/** execute pitch detection on a multichannel input buffer
+
+  \param o pitch detection object as returned by new_aubio_pitchyinfast_multi()
+  \param samples_in input signal matrix, [channels] x [buf_size]
+  \param cands_out pitch period candidates, in samples, one per channel
+
+*/
+void aubio_pitchyinfast_multi_do (aubio_pitchyinfast_multi_t * o,
+    const fmat_t * samples_in, fvec_t * cands_out);
+
+/** transform only the newest samples of each window
+
+  \param o multichannel YIN pitch detection object
+  \param hop_size number of new samples in each window, or 0 to transform
+  the whole window each time [default 0]
+
+  Same as aubio_pitchyinfast_set_hop_size(), for all channels. Consecutive
+  calls to aubio_pitchyinfast_multi_do() must then receive windows advancing
+  by `hop_size` samples. `hop_size` must divide `buf_size/2`.
+
+  \return 0 if successful, non-zero otherwise
+
+*/
+uint_t aubio_pitchyinfast_multi_set_hop_size (aubio_pitchyinfast_multi_t * o,
+    uint_t hop_size);
+
+/** skip the analysis of one channel on the next run
+
+  \param o multichannel YIN pitch detection object
+  \param channel channel index
+
+  The next call to aubio_pitchyinfast_multi_do() does not analyse the window
+  of `channel`, typically because it is silent, and gives it a candidate of
+  0. Same as aubio_pitchyinfast_skip(), the blocks that entered the window
+  meanwhile are transformed when the channel is analysed again.
+
+*/
+void aubio_pitchyinfast_multi_skip (aubio_pitchyinfast_multi_t * o,
+    uint_t channel);
+
+/** set tolerance parameter for YIN algorithm
+
+  \param o multichannel YIN pitch detection object
+  \param tol tolerance parameter for minima selection [default 0.15]
+
+*/
+uint_t aubio_pitchyinfast_multi_set_tolerance (aubio_pitchyinfast_multi_t * o,
+    smpl_t tol);
+
+/** get tolerance parameter for YIN algorithm
+
+  \param o multichannel YIN pitch detection object
+  \return tolerance parameter for minima selection [default 0.15]
+
+*/
+smpl_t aubio_pitchyinfast_multi_get_tolerance (aubio_pitchyinfast_multi_t * o);
+
+/** get current confidence of YIN algorithm for one channel
+
+  \param o multichannel YIN pitch detection object
+  \param channel channel index
+  \return confidence parameter
+
+*/
+smpl_t aubio_pitchyinfast_multi_get_confidence (aubio_pitchyinfast_multi_t * o,
+    uint_t channel);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AUBIO_PITCHYINFASTMULTI_H */
@@ -24,19 +24,24 @@
 #include "mathutils.h"
 #include "spectral/fft.h"
 #include "pitch/pitchyinfft.h"
+#include "utils/cache.h"
 
 /** pitch yinfft structure */
 struct _aubio_pitchyinfft_t
 {
   fvec_t *win;        /**< temporal weighting window */
-  fvec_t *winput;     /**< windowed spectrum */
-  fvec_t *sqrmag;     /**< square difference function */
   fvec_t *weight;     /**< spectral weighting window (psychoacoustic model) */
   fvec_t *fftout;     /**< Fourier transform output */
+  fvec_t *spectrum;   /**< Fourier transform of the windowed input */
   aubio_fft_t *fft;   /**< fft object to compute square difference function */
+  aubio_fft_t *dct_fft; /**< fft object of half size for the cosine transform */
+  fvec_t *dct_cos;    /**< cos (PI * j / (bufsize / 2)) */
+  fvec_t *dct_sin;    /**< sin (PI * j / (bufsize / 2)) */
   fvec_t *yinfft;     /**< Yin function */
   smpl_t tol;         /**< Yin tolerance */
   uint_t peak_pos;    /**< currently selected peak pos*/
+  uint_t tau_min;     /**< shortest period searched */
+  uint_t tau_max;     /**< longest period searched */
   uint_t short_period; /** shortest period under which to check for octave error */
 };
 
@@ -54,56 +59,148 @@ static const smpl_t weight[] = {
   -7.40,  -17.8,  -17.8,  -17.8
 };
 
+static void
+aubio_pitchyinfft_set_weight (fvec_t * out, uint_t samplerate, uint_t bufsize)
+{
+  const uint_t n_freqs = sizeof (freqs) / sizeof (freqs[0]);
+  const smpl_t step = (smpl_t) samplerate / (smpl_t) bufsize;
+  uint_t i = 0, j = 1;
+  smpl_t freq, slope;
+  lsmp_t gain, ratio;
+  while (i < out->length) {
+    freq = i * step;
+    // past the last frequency of the table, keep its last segment
+    while (j < n_freqs - 1 && freq > freqs[j]) {
+      j += 1;
+    }
+    // the weight in dB is linear in frequency between two frequencies of
+    // the table, so its linear value is a geometric progression across the
+    // bins in between
+    slope = (weight[j] - weight[j - 1]) / (freqs[j] - freqs[j - 1]);
+    gain = DB2LIN (weight[j - 1] + slope * (freq - freqs[j - 1]));
+    ratio = DB2LIN (slope * step);
+    do {
+      // doubled, as the bins of the squared magnitude spectrum are counted
+      // twice in the square difference function but once in its cosine
+      // transform, see aubio_pitchyinfft_dct
+      out->data[i] = 2. * gain;
+      gain *= ratio;
+      i += 1;
+    } while (i < out->length && (j == n_freqs - 1 || i * step <= freqs[j]));
+  }
+}
+
+/* the weights and the twiddles of the cosine transform are shared by the
+ * objects of the same buffer size and samplerate, see utils/cache.h */
+static uint_t
+aubio_pitchyinfft_fill_weight (void * table, uint_t bufsize,
+    uint_t samplerate, const void * arg UNUSED)
+{
+  fvec_t out;
+  out.length = bufsize / 2 + 1;
+  out.data = (smpl_t *) table;
+  aubio_pitchyinfft_set_weight (&out, samplerate, bufsize);
+  return AUBIO_OK;
+}
+
+static uint_t
+aubio_pitchyinfft_fill_dct_cos (void * table, uint_t bufsize,
+    uint_t samplerate UNUSED, const void * arg UNUSED)
+{
+  smpl_t *c = (smpl_t *) table;
+  uint_t j;
+  for (j = 0; j < bufsize / 4; j++) {
+    c[j] = COS (PI * j / (bufsize / 2));
+  }
+  return AUBIO_OK;
+}
+
+static uint_t
+aubio_pitchyinfft_fill_dct_sin (void * table, uint_t bufsize,
+    uint_t samplerate UNUSED, const void * arg UNUSED)
+{
+  smpl_t *s = (smpl_t *) table;
+  uint_t j;
+  for (j = 0; j < bufsize / 4; j++) {
+    s[j] = SIN (PI * j / (bufsize / 2));
+  }
+  return AUBIO_OK;
+}
+
 aubio_pitchyinfft_t *
 new_aubio_pitchyinfft (uint_t samplerate, uint_t bufsize)
 {
-  uint_t i = 0, j = 1;
-  smpl_t freq = 0, a0 = 0, a1 = 0, f0 = 0, f1 = 0;
   aubio_pitchyinfft_t *p = AUBIO_NEW (aubio_pitchyinfft_t);
-  p->winput = new_fvec (bufsize);
+  // the cosine transform folds the half size transform in two
+  if ((sint_t)bufsize < 4 || bufsize % 4 != 0) {
+    AUBIO_ERR ("pitchyinfft: got buffer size %d, but can not be < 4"
+        " or not a multiple of 4\n", bufsize);
+    goto beach;
+  }
   p->fft = new_aubio_fft (bufsize);
   if (!p->fft) goto beach;
+  p->dct_fft = new_aubio_fft (bufsize / 2);
+  if (!p->dct_fft) goto beach;
   p->fftout = new_fvec (bufsize);
-  p->sqrmag = new_fvec (bufsize);
+  p->spectrum = new_fvec (bufsize);
   p->yinfft = new_fvec (bufsize / 2 + 1);
   p->tol = 0.85;
   p->peak_pos = 0;
-  p->win = new_aubio_window ("hanningz", bufsize);
-  p->weight = new_fvec (bufsize / 2 + 1);
-  for (i = 0; i < p->weight->length; i++) {
-    freq = (smpl_t) i / (smpl_t) bufsize *(smpl_t) samplerate;
-    while (freq > freqs[j]) {
-      j += 1;
-    }
-    a0 = weight[j - 1];
-    f0 = freqs[j - 1];
-    a1 = weight[j];
-    f1 = freqs[j];
-    if (f0 == f1) {           // just in case
-      p->weight->data[i] = a0;
-    } else if (f0 == 0) {     // y = ax+b
-      p->weight->data[i] = (a1 - a0) / f1 * freq + a0;
-    } else {
-      p->weight->data[i] = (a1 - a0) / (f1 - f0) * freq +
-          (a0 - (a1 - a0) / (f1 / f0 - 1.));
-    }
-    while (freq > freqs[j]) {
-      j += 1;
-    }
-    //AUBIO_DBG("%f\n",p->weight->data[i]);
-    p->weight->data[i] = DB2LIN (p->weight->data[i]);
-    //p->weight->data[i] = SQRT(DB2LIN(p->weight->data[i]));
-  }
+  p->tau_min = 0;
+  p->tau_max = bufsize / 2;
+  p->win = aubio_cache_acquire_window ("hanningz", bufsize);
+  p->weight = aubio_cache_acquire_fvec ("yinfft_weight", bufsize, samplerate,
+      bufsize / 2 + 1, aubio_pitchyinfft_fill_weight, NULL);
+  p->dct_cos = aubio_cache_acquire_fvec ("yinfft_dct_cos", bufsize, 0,
+      bufsize / 4, aubio_pitchyinfft_fill_dct_cos, NULL);
+  p->dct_sin = aubio_cache_acquire_fvec ("yinfft_dct_sin", bufsize, 0,
+      bufsize / 4, aubio_pitchyinfft_fill_dct_sin, NULL);
   // check for octave errors above 1300 Hz
   p->short_period = (uint_t)ROUND(samplerate / 1300.);
   return p;
 
 beach:
-  if (p->winput) del_fvec(p->winput);
+  if (p->fft) del_aubio_fft (p->fft);
   AUBIO_FREE(p);
   return NULL;
 }
 
+/* Replace y[0..m], m = bufsize / 2, by its cosine transform
+
+     y[k] = (y[0] + (-1)^k y[m]) / 2 + sum_{j=1}^{m-1} y[j] cos (PI j k / m)
+
+   which is half of the fft of the even sequence of size 2 m mirroring it.
+   The sequence is folded into m values whose real fft gives the even terms,
+   and the odd terms are a running sum of the imaginary parts. */
+static void
+aubio_pitchyinfft_dct (aubio_pitchyinfft_t * p, smpl_t * y)
+{
+  const uint_t m = p->dct_cos->length * 2;
+  const smpl_t *c = p->dct_cos->data;
+  const smpl_t *s = p->dct_sin->data;
+  smpl_t sum = .5 * (y[0] - y[m]), y1, y2;
+  fvec_t folded;
+  uint_t j;
+  y[0] = .5 * (y[0] + y[m]);
+  for (j = 1; j < m / 2; j++) {
+    y1 = .5 * (y[j] + y[m - j]);
+    y2 = y[j] - y[m - j];
+    y[j] = y1 - s[j] * y2;
+    y[m - j] = y1 + s[j] * y2;
+    sum += c[j] * y2;
+  }
+  folded.data = y;
+  folded.length = m;
+  aubio_fft_do_packed (p->dct_fft, &folded);
+  // the real part of bin m / 2 is stored second
+  y[m] = y[1];
+  y[1] = sum;
+  for (j = 3; j < m; j += 2) {
+    sum += y[j];
+    y[j] = sum;
+  }
+}
+
 void
 aubio_pitchyinfft_do (aubio_pitchyinfft_t * p, const fvec_t * input, fvec_t * output)
 {
@@ -111,31 +208,36 @@ aubio_pitchyinfft_do (aubio_pitchyinfft_t * p, const fvec_t * input, fvec_t * ou
   uint_t length = p->fftout->length;
   uint_t halfperiod;
   fvec_t *fftout = p->fftout;
+  fvec_t *spectrum = p->spectrum;
   fvec_t *yin = p->yinfft;
+  const uint_t tau_min = p->tau_min;
+  // stop a few lags past tau_max, enough to interpolate its peak
+  const uint_t tau_end = MIN (p->tau_max + 4, yin->length);
+  fvec_t tmp_slice;
   smpl_t tmp = 0., sum = 0.;
   // window the input
-  fvec_weighted_copy(input, p->win, p->winput);
-  // get the real / imag parts of its fft
-  aubio_fft_do_complex (p->fft, p->winput, fftout);
-  // get the squared magnitude spectrum, applying some weight
-  p->sqrmag->data[0] = SQR(fftout->data[0]);
-  p->sqrmag->data[0] *= p->weight->data[0];
+  fvec_weighted_copy(input, p->win, spectrum);
+  // get the packed real / imag parts of its fft
+  aubio_fft_do_packed (p->fft, spectrum);
+  // get the squared magnitude spectrum, applying some weight, and the sum
+  // of weighted squared mags
+  fftout->data[0] = SQR(spectrum->data[0]);
+  fftout->data[0] *= p->weight->data[0];
   for (l = 1; l < length / 2; l++) {
-    p->sqrmag->data[l] = SQR(fftout->data[l]) + SQR(fftout->data[length - l]);
-    p->sqrmag->data[l] *= p->weight->data[l];
-    p->sqrmag->data[length - l] = p->sqrmag->data[l];
+    fftout->data[l] = SQR(spectrum->data[2 * l])
+      + SQR(spectrum->data[2 * l + 1]);
+    fftout->data[l] *= p->weight->data[l];
   }
-  p->sqrmag->data[length / 2] = SQR(fftout->data[length / 2]);
-  p->sqrmag->data[length / 2] *= p->weight->data[length / 2];
-  // get sum of weighted squared mags
+  fftout->data[length / 2] = SQR(spectrum->data[1]);
+  fftout->data[length / 2] *= p->weight->data[length / 2];
   for (l = 0; l < length / 2 + 1; l++) {
-    sum += p->sqrmag->data[l];
+    sum += fftout->data[l];
   }
-  sum *= 2.;
-  // get the real / imag parts of the fft of the squared magnitude
-  aubio_fft_do_complex (p->fft, p->sqrmag, fftout);
+  // the squared magnitude spectrum is real and even, so its fft is the
+  // cosine transform of its first half
+  aubio_pitchyinfft_dct (p, fftout->data);
   yin->data[0] = 1.;
-  for (tau = 1; tau < yin->length; tau++) {
+  for (tau = 1; tau < tau_end; tau++) {
     // compute the square differences
     yin->data[tau] = sum - fftout->data[tau];
     // and the cumulative mean normalized difference function
@@ -146,8 +248,10 @@ aubio_pitchyinfft_do (aubio_pitchyinfft_t * p, const fvec_t * input, fvec_t * ou
       yin->data[tau] = 1.;
     }
   }
-  // find best candidates
-  tau = fvec_min_elem (yin);
+  // find best candidates within the lag range
+  tmp_slice.data = yin->data + tau_min;
+  tmp_slice.length = p->tau_max + 1 - tau_min;
+  tau = tau_min + fvec_min_elem (&tmp_slice);
   if (yin->data[tau] < p->tol) {
     // no interpolation, directly return the period as an integer
     //output->data[0] = tau;
@@ -155,13 +259,17 @@ aubio_pitchyinfft_do (aubio_pitchyinfft_t * p, const fvec_t * input, fvec_t * ou
 
     // 3 point quadratic interpolation
     //return fvec_quadratic_peak_pos (yin,tau,1);
-    /* additional check for (unlikely) octave doubling in higher frequencies */
-    if (tau > p->short_period) {
+    if (tau == tau_min || tau == p->tau_max) {
+      // the minimum lies outside the lag range, no pitch
+      p->peak_pos = 0;
+      output->data[0] = 0.;
+    } else if (tau > p->short_period) {
       output->data[0] = fvec_quadratic_peak_pos (yin, tau);
     } else {
+      /* additional check for (unlikely) octave doubling in higher frequencies */
       /* should compare the minimum value of each interpolated peaks */
       halfperiod = FLOOR (tau / 2 + .5);
-      if (yin->data[halfperiod] < p->tol)
+      if (halfperiod >= tau_min && yin->data[halfperiod] < p->tol)
         p->peak_pos = halfperiod;
       else
         p->peak_pos = tau;
@@ -176,16 +284,24 @@ aubio_pitchyinfft_do (aubio_pitchyinfft_t * p, const fvec_t * input, fvec_t * ou
 void
 del_aubio_pitchyinfft (aubio_pitchyinfft_t * p)
 {
-  del_fvec (p->win);
+  aubio_cache_release_fvec (p->win);
   del_aubio_fft (p->fft);
+  del_aubio_fft (p->dct_fft);
+  aubio_cache_release_fvec (p->dct_cos);
+  aubio_cache_release_fvec (p->dct_sin);
   del_fvec (p->yinfft);
-  del_fvec (p->sqrmag);
   del_fvec (p->fftout);
-  del_fvec (p->winput);
-  del_fvec (p->weight);
+  del_fvec (p->spectrum);
+  aubio_cache_release_fvec (p->weight);
   AUBIO_FREE (p);
 }
 
+void
+aubio_pitchyinfft_get_spectrum (aubio_pitchyinfft_t * o, cvec_t * spectrum)
+{
+  aubio_fft_packed_get_norm (o->spectrum, spectrum);
+}
+
 smpl_t
 aubio_pitchyinfft_get_confidence (aubio_pitchyinfft_t * o) {
   return 1. - o->yinfft->data[o->peak_pos];
@@ -203,3 +319,18 @@ aubio_pitchyinfft_get_tolerance (aubio_pitchyinfft_t * p)
 {
   return p->tol;
 }
+
+uint_t
+aubio_pitchyinfft_set_tau_range (aubio_pitchyinfft_t * o, uint_t tau_min,
+    uint_t tau_max)
+{
+  uint_t last = o->yinfft->length - 1;
+  if (tau_min > tau_max) {
+    AUBIO_ERR ("pitchyinfft: tau_min (%d) is larger than tau_max (%d)\n",
+        tau_min, tau_max);
+    return AUBIO_FAIL;
+  }
+  o->tau_min = MIN (tau_min, last);
+  o->tau_max = MIN (tau_max, last);
+  return AUBIO_OK;
+}
@@ -84,6 +84,21 @@ smpl_t aubio_pitchyinfft_get_tolerance (aubio_pitchyinfft_t * o);
 */
 uint_t aubio_pitchyinfft_set_tolerance (aubio_pitchyinfft_t * o, smpl_t tol);
 
+/** restrict the range of periods searched by the YIN algorithm
+
+  \param o YIN pitch detection object
+  \param tau_min shortest period, in samples [default 0]
+  \param tau_max longest period, in samples [default buf_size/2]
+
+  The normalised difference function is only computed up to a few samples
+  past `tau_max`. Both values are clipped to `buf_size/2`.
+
+  \return 0 if successful, non-zero otherwise
+
+*/
+uint_t aubio_pitchyinfft_set_tau_range (aubio_pitchyinfft_t * o,
+    uint_t tau_min, uint_t tau_max);
+
 /** get current confidence of YIN algorithm
 
   \param o YIN pitch detection object
@@ -92,6 +107,19 @@ uint_t aubio_pitchyinfft_set_tolerance (aubio_pitchyinfft_t * o, smpl_t tol);
 */
 smpl_t aubio_pitchyinfft_get_confidence (aubio_pitchyinfft_t * o);
 
+/** get the magnitude spectrum of the last analysed buffer
+
+  \param o yinfft object
+  \param spectrum output spectrum, of size `buf_size/2+1`, only the norm is
+  set
+
+  The spectrum is the one computed by aubio_pitchyinfft_do(), before the
+  perceptual weighting, on the input buffer multiplied by a Hanning window.
+
+*/
+void aubio_pitchyinfft_get_spectrum (aubio_pitchyinfft_t * o,
+    cvec_t * spectrum);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,198 @@
+/*
+  Copyright (C) 2026 the audio-to-cv-pitch-lv2 contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "aubio_priv.h"
+#include "pitch/yindiff.h"
+
+/* the vector kernels are compiled with per function target attributes, so
+ * that the rest of the library keeps the baseline instruction set */
+#if !HAVE_AUBIO_DOUBLE && (defined(__GNUC__) || defined(__clang__)) \
+  && (defined(__x86_64__) || defined(__i386__))
+#define HAVE_YINDIFF_X86 1
+#include <immintrin.h>
+#else
+#define HAVE_YINDIFF_X86 0
+#endif
+
+void
+aubio_yindiff_scalar (const smpl_t * x, uint_t start, uint_t end, uint_t tau,
+    uint_t n_lags, smpl_t * out)
+{
+  uint_t j, k;
+  smpl_t tmp, sum;
+  for (k = 0; k < n_lags; k++) {
+    sum = 0.;
+    for (j = start; j < end; j++) {
+      tmp = x[j] - x[j + tau + k];
+      sum += SQR (tmp);
+    }
+    out[k] = sum;
+  }
+}
+
+#if HAVE_YINDIFF_X86
+
+/* each kernel loads x[j] once for AUBIO_YINDIFF_LAGS lags, and falls back
+ * to the scalar kernel for a partial group of lags */
+
+__attribute__((target("sse2")))
+static smpl_t
+aubio_yindiff_hsum_sse2 (__m128 v)
+{
+  v = _mm_add_ps (v, _mm_movehl_ps (v, v));
+  v = _mm_add_ss (v, _mm_shuffle_ps (v, v, 1));
+  return _mm_cvtss_f32 (v);
+}
+
+__attribute__((target("sse2")))
+static void
+aubio_yindiff_sse2 (const smpl_t * x, uint_t start, uint_t end, uint_t tau,
+    uint_t n_lags, smpl_t * out)
+{
+  const smpl_t *y = x + tau;
+  __m128 a, d, acc0, acc1, acc2, acc3;
+  uint_t j = start, k;
+  if (n_lags != AUBIO_YINDIFF_LAGS) {
+    aubio_yindiff_scalar (x, start, end, tau, n_lags, out);
+    return;
+  }
+  acc0 = acc1 = acc2 = acc3 = _mm_setzero_ps ();
+  for (; j + 4 <= end; j += 4) {
+    a = _mm_loadu_ps (x + j);
+    d = _mm_sub_ps (a, _mm_loadu_ps (y + j));
+    acc0 = _mm_add_ps (acc0, _mm_mul_ps (d, d));
+    d = _mm_sub_ps (a, _mm_loadu_ps (y + j + 1));
+    acc1 = _mm_add_ps (acc1, _mm_mul_ps (d, d));
+    d = _mm_sub_ps (a, _mm_loadu_ps (y + j + 2));
+    acc2 = _mm_add_ps (acc2, _mm_mul_ps (d, d));
+    d = _mm_sub_ps (a, _mm_loadu_ps (y + j + 3));
+    acc3 = _mm_add_ps (acc3, _mm_mul_ps (d, d));
+  }
+  out[0] = aubio_yindiff_hsum_sse2 (acc0);
+  out[1] = aubio_yindiff_hsum_sse2 (acc1);
+  out[2] = aubio_yindiff_hsum_sse2 (acc2);
+  out[3] = aubio_yindiff_hsum_sse2 (acc3);
+  for (; j < end; j++) {
+    for (k = 0; k < AUBIO_YINDIFF_LAGS; k++) {
+      out[k] += SQR (x[j] - y[j + k]);
+    }
+  }
+}
+
+__attribute__((target("avx2,fma")))
+static smpl_t
+aubio_yindiff_hsum_avx2 (__m256 v)
+{
+  __m128 h = _mm_add_ps (_mm256_castps256_ps128 (v),
+      _mm256_extractf128_ps (v, 1));
+  h = _mm_add_ps (h, _mm_movehl_ps (h, h));
+  h = _mm_add_ss (h, _mm_shuffle_ps (h, h, 1));
+  return _mm_cvtss_f32 (h);
+}
+
+__attribute__((target("avx2,fma")))
+static void
+aubio_yindiff_avx2 (const smpl_t * x, uint_t start, uint_t end, uint_t tau,
+    uint_t n_lags, smpl_t * out)
+{
+  const smpl_t *y = x + tau;
+  __m256 a, d, acc0, acc1, acc2, acc3;
+  uint_t j = start, k;
+  if (n_lags != AUBIO_YINDIFF_LAGS) {
+    aubio_yindiff_scalar (x, start, end, tau, n_lags, out);
+    return;
+  }
+  acc0 = acc1 = acc2 = acc3 = _mm256_setzero_ps ();
+  for (; j + 8 <= end; j += 8) {
+    a = _mm256_loadu_ps (x + j);
+    d = _mm256_sub_ps (a, _mm256_loadu_ps (y + j));
+    acc0 = _mm256_fmadd_ps (d, d, acc0);
+    d = _mm256_sub_ps (a, _mm256_loadu_ps (y + j + 1));
+    acc1 = _mm256_fmadd_ps (d, d, acc1);
+    d = _mm256_sub_ps (a, _mm256_loadu_ps (y + j + 2));
+    acc2 = _mm256_fmadd_ps (d, d, acc2);
+    d = _mm256_sub_ps (a, _mm256_loadu_ps (y + j + 3));
+    acc3 = _mm256_fmadd_ps (d, d, acc3);
+  }
+  out[0] = aubio_yindiff_hsum_avx2 (acc0);
+  out[1] = aubio_yindiff_hsum_avx2 (acc1);
+  out[2] = aubio_yindiff_hsum_avx2 (acc2);
+  out[3] = aubio_yindiff_hsum_avx2 (acc3);
+  for (; j < end; j++) {
+    for (k = 0; k < AUBIO_YINDIFF_LAGS; k++) {
+      out[k] += SQR (x[j] - y[j + k]);
+    }
+  }
+}
+
+__attribute__((target("avx512f")))
+static void
+aubio_yindiff_avx512 (const smpl_t * x, uint_t start, uint_t end, uint_t tau,
+    uint_t n_lags, smpl_t * out)
+{
+  const smpl_t *y = x + tau;
+  __m512 a, d, acc0, acc1, acc2, acc3;
+  uint_t j = start, k;
+  if (n_lags != AUBIO_YINDIFF_LAGS) {
+    aubio_yindiff_scalar (x, start, end, tau, n_lags, out);
+    return;
+  }
+  acc0 = acc1 = acc2 = acc3 = _mm512_setzero_ps ();
+  for (; j + 16 <= end; j += 16) {
+    a = _mm512_loadu_ps (x + j);
+    d = _mm512_sub_ps (a, _mm512_loadu_ps (y + j));
+    acc0 = _mm512_fmadd_ps (d, d, acc0);
+    d = _mm512_sub_ps (a, _mm512_loadu_ps (y + j + 1));
+    acc1 = _mm512_fmadd_ps (d, d, acc1);
+    d = _mm512_sub_ps (a, _mm512_loadu_ps (y + j + 2));
+    acc2 = _mm512_fmadd_ps (d, d, acc2);
+    d = _mm512_sub_ps (a, _mm512_loadu_ps (y + j + 3));
+    acc3 = _mm512_fmadd_ps (d, d, acc3);
+  }
+  out[0] = _mm512_reduce_add_ps (acc0);
+  out[1] = _mm512_reduce_add_ps (acc1);
+  out[2] = _mm512_reduce_add_ps (acc2);
+  out[3] = _mm512_reduce_add_ps (acc3);
+  for (; j < end; j++) {
+    for (k = 0; k < AUBIO_YINDIFF_LAGS; k++) {
+      out[k] += SQR (x[j] - y[j + k]);
+    }
+  }
+}
+
+#endif /* HAVE_YINDIFF_X86 */
+
+aubio_yindiff_t
+aubio_yindiff_get_kernel (void)
+{
+#if HAVE_YINDIFF_X86
+  __builtin_cpu_init ();
+  if (__builtin_cpu_supports ("avx512f")) {
+    return aubio_yindiff_avx512;
+  }
+  if (__builtin_cpu_supports ("avx2") && __builtin_cpu_supports ("fma")) {
+    return aubio_yindiff_avx2;
+  }
+  if (__builtin_cpu_supports ("sse2")) {
+    return aubio_yindiff_sse2;
+  }
+#endif /* HAVE_YINDIFF_X86 */
+  return aubio_yindiff_scalar;
+}
@@ -0,0 +1,74 @@
+/*
+  Copyright (C) 2026 the audio-to-cv-pitch-lv2 contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/** \file
+
+  Squared difference kernels of the time-domain YIN algorithm
+
+  The kernels compute the difference function of a block of samples for a
+  few consecutive lags at once, so that each sample of the block is loaded
+  once for all of them. Besides the scalar reference, SSE2, AVX2 and AVX-512
+  versions are built on x86 with GCC or Clang, and the fastest one supported
+  by the processor is selected at runtime.
+
+*/
+
+#ifndef AUBIO_YINDIFF_H
+#define AUBIO_YINDIFF_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** maximum number of lags computed by one call of a kernel */
+#define AUBIO_YINDIFF_LAGS 4
+
+/** squared difference kernel
+
+  \param x input samples
+  \param start first sample of the block
+  \param end sample after the last one of the block
+  \param tau first lag
+  \param n_lags number of consecutive lags, at most ::AUBIO_YINDIFF_LAGS
+  \param out `n_lags` values, the sum of `SQR (x[j] - x[j + tau + k])` for
+  `j` in `[start, end)` at `out[k]`
+
+  `x` must hold at least `end + tau + n_lags - 1` samples.
+
+*/
+typedef void (*aubio_yindiff_t) (const smpl_t * x, uint_t start, uint_t end,
+    uint_t tau, uint_t n_lags, smpl_t * out);
+
+/** scalar reference kernel, see ::aubio_yindiff_t */
+void aubio_yindiff_scalar (const smpl_t * x, uint_t start, uint_t end,
+    uint_t tau, uint_t n_lags, smpl_t * out);
+
+/** get the fastest kernel supported by the processor
+
+  \return the kernel, ::aubio_yindiff_scalar when no vector kernel applies
+
+*/
+aubio_yindiff_t aubio_yindiff_get_kernel (void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AUBIO_YINDIFF_H */
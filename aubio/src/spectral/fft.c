@@ -23,6 +23,7 @@
 #include "cvec.h"
 #include "mathutils.h"
 #include "spectral/fft.h"
+#include "utils/cache.h"
 
 #ifdef HAVE_FFTW3             // using FFTW3
 /* note that <complex.h> is not included here but only in aubio_priv.h, so that
@@ -60,6 +61,9 @@ typedef FFTW_TYPE fft_data_t;
 #define fftw_plan_r2r_1d       fftwf_plan_r2r_1d
 #define fftw_plan              fftwf_plan
 #define fftw_destroy_plan      fftwf_destroy_plan
+#define fftw_import_wisdom_from_filename fftwf_import_wisdom_from_filename
+#define fftw_import_system_wisdom        fftwf_import_system_wisdom
+#define fftw_export_wisdom_to_filename   fftwf_export_wisdom_to_filename
 #endif
 
 #ifdef HAVE_FFTW3F
@@ -77,6 +81,16 @@ typedef FFTW_TYPE fft_data_t;
 // a global mutex for FFTW thread safety
 pthread_mutex_t aubio_fftw_mutex = PTHREAD_MUTEX_INITIALIZER;
 
+// rigor of the plans taken from the wisdom
+#ifdef HAVE_FFTW3_PATIENT
+#define AUBIO_FFTW_RIGOR FFTW_PATIENT
+#else
+#define AUBIO_FFTW_RIGOR FFTW_MEASURE
+#endif
+
+// when set, plans missing from the wisdom are measured instead of estimated
+static uint_t aubio_fftw_measure = 0;
+
 #elif defined HAVE_ACCELERATE        // using ACCELERATE
 // https://developer.apple.com/library/mac/#documentation/Accelerate/Reference/vDSPRef/Reference/reference.html
 #include <Accelerate/Accelerate.h>
@@ -136,9 +150,44 @@ pthread_mutex_t aubio_fftw_mutex = PTHREAD_MUTEX_INITIALIZER;
 #endif
 
 
+#elif defined HAVE_SIMD_FFT  // using SIMD_FFT
+// vectorised fft, with the packed format and scaling of ooura
+typedef struct _aubio_simd_fft_t aubio_simd_fft_t;
+extern aubio_simd_fft_t *new_aubio_simd_fft(uint_t);
+extern void del_aubio_simd_fft(aubio_simd_fft_t *);
+extern void aubio_simd_fft_rdft(aubio_simd_fft_t *, int, smpl_t *);
+#define aubio_fft_rdft(s, isgn, data) \
+  aubio_simd_fft_rdft(s->simd, isgn, data)
+
 #else // using OOURA
 // let's use ooura instead
 extern void aubio_ooura_rdft(int, int, smpl_t *, int *, smpl_t *);
+// and the mixed radix fft for the sizes that are not powers of two
+typedef struct _aubio_simd_fft_t aubio_simd_fft_t;
+extern aubio_simd_fft_t *new_aubio_simd_fft(uint_t);
+extern void del_aubio_simd_fft(aubio_simd_fft_t *);
+extern void aubio_simd_fft_rdft(aubio_simd_fft_t *, int, smpl_t *);
+#define aubio_fft_rdft(s, isgn, data) \
+  ((s)->simd ? aubio_simd_fft_rdft(s->simd, isgn, data) \
+   : aubio_ooura_rdft(s->winsize, isgn, data, s->ip, s->w))
+
+// ooura computes its twiddles in w on the first transform and only reads
+// them afterwards, so that transform is done once, when the twiddles of a
+// size enter the cache, and they are shared by all the objects of that size.
+// ip[0..1] give the lengths of the twiddles, and are stored after them, but
+// ip[2..] is rewritten by every transform, so each object has its own ip.
+static uint_t aubio_fft_ooura_fill(void *table, uint_t size,
+    uint_t samplerate UNUSED, const void *arg UNUSED) {
+  smpl_t *w = (smpl_t *)table;
+  int *ip = AUBIO_ARRAY(int, size / 2 + 1);
+  smpl_t *data = AUBIO_ARRAY(smpl_t, size);
+  ip[0] = 0;
+  aubio_ooura_rdft(size, 1, data, ip, w);
+  memcpy(w + size / 2 + 1, ip, 2 * sizeof(int));
+  AUBIO_FREE(data);
+  AUBIO_FREE(ip);
+  return AUBIO_OK;
+}
 
 #endif
 
@@ -164,10 +213,16 @@ struct _aubio_fft_t {
   Ipp8u* memBuffer;
   struct aubio_FFTSpec* fftSpec;
   aubio_IppComplex* complexOut;
+
+#elif defined HAVE_SIMD_FFT   // using SIMD_FFT
+  smpl_t *in, *out;
+  aubio_simd_fft_t *simd;
+
 #else                         // using OOURA
   smpl_t *in, *out;
   smpl_t *w;
   int *ip;
+  aubio_simd_fft_t *simd;
 #endif /* using OOURA */
 
   fvec_t * compspec;
@@ -182,6 +237,7 @@ aubio_fft_t * new_aubio_fft (uint_t winsize) {
 
 #ifdef HAVE_FFTW3
   uint_t i;
+  unsigned flags;
   s->winsize  = winsize;
   /* allocate memory */
   s->in       = AUBIO_ARRAY(real_t,winsize);
@@ -189,16 +245,32 @@ aubio_fft_t * new_aubio_fft (uint_t winsize) {
   s->compspec = new_fvec(winsize);
   /* create plans */
   pthread_mutex_lock(&aubio_fftw_mutex);
+  // measuring runs transforms for each candidate plan, which can take
+  // seconds, so by default only the plans found in the wisdom are used, and
+  // the others estimated
+  flags = AUBIO_FFTW_RIGOR | (aubio_fftw_measure ? 0 : FFTW_WISDOM_ONLY);
 #ifdef HAVE_COMPLEX_H
   s->fft_size = winsize/2 + 1;
   s->specdata = (fft_data_t*)fftw_malloc(sizeof(fft_data_t)*s->fft_size);
-  s->pfw = fftw_plan_dft_r2c_1d(winsize, s->in,  s->specdata, FFTW_ESTIMATE);
-  s->pbw = fftw_plan_dft_c2r_1d(winsize, s->specdata, s->out, FFTW_ESTIMATE);
+  s->pfw = fftw_plan_dft_r2c_1d(winsize, s->in,  s->specdata, flags);
+  if (!s->pfw) {
+    s->pfw = fftw_plan_dft_r2c_1d(winsize, s->in,  s->specdata, FFTW_ESTIMATE);
+  }
+  s->pbw = fftw_plan_dft_c2r_1d(winsize, s->specdata, s->out, flags);
+  if (!s->pbw) {
+    s->pbw = fftw_plan_dft_c2r_1d(winsize, s->specdata, s->out, FFTW_ESTIMATE);
+  }
 #else
   s->fft_size = winsize;
   s->specdata = (fft_data_t*)fftw_malloc(sizeof(fft_data_t)*s->fft_size);
-  s->pfw = fftw_plan_r2r_1d(winsize, s->in,  s->specdata, FFTW_R2HC, FFTW_ESTIMATE);
-  s->pbw = fftw_plan_r2r_1d(winsize, s->specdata, s->out, FFTW_HC2R, FFTW_ESTIMATE);
+  s->pfw = fftw_plan_r2r_1d(winsize, s->in,  s->specdata, FFTW_R2HC, flags);
+  if (!s->pfw) {
+    s->pfw = fftw_plan_r2r_1d(winsize, s->in,  s->specdata, FFTW_R2HC, FFTW_ESTIMATE);
+  }
+  s->pbw = fftw_plan_r2r_1d(winsize, s->specdata, s->out, FFTW_HC2R, flags);
+  if (!s->pbw) {
+    s->pbw = fftw_plan_r2r_1d(winsize, s->specdata, s->out, FFTW_HC2R, FFTW_ESTIMATE);
+  }
 #endif
   pthread_mutex_unlock(&aubio_fftw_mutex);
   for (i = 0; i < s->winsize; i++) {
@@ -257,20 +329,32 @@ aubio_fft_t * new_aubio_fft (uint_t winsize) {
     goto beach;
   }
 
+#elif defined HAVE_SIMD_FFT   // using SIMD_FFT
+  s->simd = new_aubio_simd_fft(winsize);
+  if (!s->simd) goto beach;
+  s->winsize = winsize;
+  s->fft_size = winsize / 2 + 1;
+  s->compspec = new_fvec(winsize);
+  s->in    = AUBIO_ARRAY(smpl_t, s->winsize);
+  s->out   = AUBIO_ARRAY(smpl_t, s->winsize);
+
 #else                         // using OOURA
   if (aubio_is_power_of_two(winsize) != 1) {
-    AUBIO_ERR("fft: can only create with sizes power of two, requested %d,"
-        " try recompiling aubio with --enable-fftw3\n", winsize);
-    goto beach;
+    s->simd = new_aubio_simd_fft(winsize);
+    if (!s->simd) goto beach;
   }
   s->winsize = winsize;
   s->fft_size = winsize / 2 + 1;
   s->compspec = new_fvec(winsize);
   s->in    = AUBIO_ARRAY(smpl_t, s->winsize);
   s->out   = AUBIO_ARRAY(smpl_t, s->winsize);
-  s->ip    = AUBIO_ARRAY(int   , s->fft_size);
-  s->w     = AUBIO_ARRAY(smpl_t, s->fft_size);
-  s->ip[0] = 0;
+  if (!s->simd) {
+    s->w   = (smpl_t *)aubio_cache_acquire("ooura_fft", winsize, 0,
+        s->fft_size * sizeof(smpl_t) + 2 * sizeof(int), aubio_fft_ooura_fill,
+        NULL);
+    s->ip  = AUBIO_ARRAY(int, s->fft_size);
+    memcpy(s->ip, s->w + s->fft_size, 2 * sizeof(int));
+  }
 #endif /* using OOURA */
 
   return s;
@@ -300,9 +384,15 @@ void del_aubio_fft(aubio_fft_t * s) {
   ippFree(s->memBuffer);
   ippFree(s->complexOut);
 
+#elif defined HAVE_SIMD_FFT   // using SIMD_FFT
+  del_aubio_simd_fft(s->simd);
+
 #else                         // using OOURA
-  AUBIO_FREE(s->w);
-  AUBIO_FREE(s->ip);
+  if (s->simd) del_aubio_simd_fft(s->simd);
+  else {
+    aubio_cache_release(s->w);
+    AUBIO_FREE(s->ip);
+  }
 #endif
 
   del_fvec(s->compspec);
@@ -311,6 +401,50 @@ void del_aubio_fft(aubio_fft_t * s) {
   AUBIO_FREE(s);
 }
 
+uint_t aubio_fft_load_wisdom(const char_t * path) {
+#ifdef HAVE_FFTW3
+  int loaded;
+  pthread_mutex_lock(&aubio_fftw_mutex);
+  if (path) {
+    loaded = fftw_import_wisdom_from_filename(path);
+  } else {
+    loaded = fftw_import_system_wisdom();
+  }
+  pthread_mutex_unlock(&aubio_fftw_mutex);
+  return loaded ? AUBIO_OK : AUBIO_FAIL;
+#else
+  (void)path;
+  return AUBIO_FAIL;
+#endif
+}
+
+uint_t aubio_fft_save_wisdom(const char_t * path) {
+#ifdef HAVE_FFTW3
+  int saved;
+  pthread_mutex_lock(&aubio_fftw_mutex);
+  saved = fftw_export_wisdom_to_filename(path);
+  pthread_mutex_unlock(&aubio_fftw_mutex);
+  if (!saved) {
+    AUBIO_ERR("fft: failed writing wisdom to %s\n", path);
+  }
+  return saved ? AUBIO_OK : AUBIO_FAIL;
+#else
+  AUBIO_ERR("fft: no wisdom to write to %s, aubio was compiled without"
+      " fftw3\n", path);
+  return AUBIO_FAIL;
+#endif
+}
+
+void aubio_fft_set_measure(uint_t measure) {
+#ifdef HAVE_FFTW3
+  pthread_mutex_lock(&aubio_fftw_mutex);
+  aubio_fftw_measure = measure;
+  pthread_mutex_unlock(&aubio_fftw_mutex);
+#else
+  (void)measure;
+#endif
+}
+
 void aubio_fft_do(aubio_fft_t * s, const fvec_t * input, cvec_t * spectrum) {
   aubio_fft_do_complex(s, input, s->compspec);
   aubio_fft_get_spectrum(s->compspec, spectrum);
@@ -374,8 +508,8 @@ void aubio_fft_do_complex(aubio_fft_t * s, const fvec_t * input, fvec_t * compsp
     compspec->data[s->fft_size - i] = s->complexOut[i].im;
   }
 
-#else                         // using OOURA
-  aubio_ooura_rdft(s->winsize, 1, s->in, s->ip, s->w);
+#else                         // using OOURA or SIMD_FFT
+  aubio_fft_rdft(s, 1, s->in);
   compspec->data[0] = s->in[0];
   compspec->data[s->winsize / 2] = s->in[1];
   for (i = 1; i < s->fft_size - 1; i++) {
@@ -441,7 +575,7 @@ void aubio_fft_rdo_complex(aubio_fft_t * s, const fvec_t * compspec, fvec_t * ou
   // apply scaling
   aubio_ippsMulC(output->data, 1.0 / s->winsize, output->data, s->fft_size);
 
-#else                         // using OOURA
+#else                         // using OOURA or SIMD_FFT
   smpl_t scale = 2.0 / s->winsize;
   s->out[0] = compspec->data[0];
   s->out[1] = compspec->data[s->winsize / 2];
@@ -449,13 +583,87 @@ void aubio_fft_rdo_complex(aubio_fft_t * s, const fvec_t * compspec, fvec_t * ou
     s->out[2 * i] = compspec->data[i];
     s->out[2 * i + 1] = - compspec->data[s->winsize - i];
   }
-  aubio_ooura_rdft(s->winsize, -1, s->out, s->ip, s->w);
+  aubio_fft_rdft(s, -1, s->out);
   for (i=0; i < s->winsize; i++) {
     output->data[i] = s->out[i] * scale;
   }
 #endif
 }
 
+#if defined HAVE_FFTW3 || defined HAVE_ACCELERATE || defined HAVE_INTEL_IPP
+/* convert from real imag [ r0, r1, ..., rN, iN-1, .., i2, i1]
+ * to packed format       [ r0, rN, r1, -i1, ..., rN-1, -iN-1 ] */
+static void aubio_fft_pack(const fvec_t * compspec, fvec_t * packed) {
+  uint_t i;
+  packed->data[0] = compspec->data[0];
+  packed->data[1] = compspec->data[compspec->length / 2];
+  for (i = 1; i < compspec->length / 2; i++) {
+    packed->data[2 * i] = compspec->data[i];
+    packed->data[2 * i + 1] = - compspec->data[compspec->length - i];
+  }
+}
+
+static void aubio_fft_unpack(const fvec_t * packed, fvec_t * compspec) {
+  uint_t i;
+  compspec->data[0] = packed->data[0];
+  compspec->data[compspec->length / 2] = packed->data[1];
+  for (i = 1; i < compspec->length / 2; i++) {
+    compspec->data[i] = packed->data[2 * i];
+    compspec->data[compspec->length - i] = - packed->data[2 * i + 1];
+  }
+}
+#endif
+
+void aubio_fft_do_packed(aubio_fft_t * s, fvec_t * data) {
+#if defined HAVE_FFTW3 || defined HAVE_ACCELERATE || defined HAVE_INTEL_IPP
+  aubio_fft_do_complex(s, data, s->compspec);
+  aubio_fft_pack(s->compspec, data);
+#else                         // using OOURA or SIMD_FFT
+  // the packed format is the one of ooura, transform in place
+  aubio_fft_rdft(s, 1, data->data);
+#endif
+}
+
+void aubio_fft_rdo_packed(aubio_fft_t * s, fvec_t * data) {
+#if defined HAVE_FFTW3 || defined HAVE_ACCELERATE || defined HAVE_INTEL_IPP
+  aubio_fft_unpack(data, s->compspec);
+  aubio_fft_rdo_complex(s, s->compspec, data);
+#else                         // using OOURA or SIMD_FFT
+  uint_t i;
+  smpl_t scale = 2.0 / s->winsize;
+  aubio_fft_rdft(s, -1, data->data);
+  for (i = 0; i < s->winsize; i++) {
+    data->data[i] *= scale;
+  }
+#endif
+}
+
+void aubio_fft_packed_mul_conj(const fvec_t * a, const fvec_t * b,
+    fvec_t * out) {
+  uint_t i;
+  smpl_t re, im;
+  out->data[0] = a->data[0] * b->data[0];
+  out->data[1] = a->data[1] * b->data[1];
+  for (i = 2; i < out->length; i += 2) {
+    // conj(a) * b, the packed format holding conjugate spectra gives the
+    // packed conjugate of the product with the same formula
+    re = a->data[i] * b->data[i] + a->data[i + 1] * b->data[i + 1];
+    im = a->data[i] * b->data[i + 1] - a->data[i + 1] * b->data[i];
+    out->data[i] = re;
+    out->data[i + 1] = im;
+  }
+}
+
+void aubio_fft_packed_get_norm(const fvec_t * packed, cvec_t * spectrum) {
+  uint_t i;
+  spectrum->norm[0] = ABS(packed->data[0]);
+  for (i = 1; i < spectrum->length - 1; i++) {
+    spectrum->norm[i] = SQRT(SQR(packed->data[2 * i])
+        + SQR(packed->data[2 * i + 1]));
+  }
+  spectrum->norm[spectrum->length - 1] = ABS(packed->data[1]);
+}
+
 void aubio_fft_get_spectrum(const fvec_t * compspec, cvec_t * spectrum) {
   aubio_fft_get_phas(compspec, spectrum);
   aubio_fft_get_norm(compspec, spectrum);
@@ -24,6 +24,8 @@
 
   Depending on how aubio was compiled, FFT are computed using one of:
     - [Ooura](http://www.kurims.kyoto-u.ac.jp/~ooura/fft.html)
+    - a built-in mixed radix fft with sse2 and avx2 butterflies
+      (`HAVE_SIMD_FFT`)
     - [FFTW3](http://www.fftw.org)
     - [vDSP](https://developer.apple.com/library/mac/#documentation/Accelerate/Reference/vDSPRef/Reference/reference.html)
 
@@ -49,6 +51,11 @@ typedef struct _aubio_fft_t aubio_fft_t;
 
   \param size length of the FFT
 
+  FFTW3 accepts any size. Ooura and the built-in fft accept any even size,
+  and are fastest for sizes whose half has no prime factor other than 2, 3
+  and 5; the other sizes are computed with Bluestein's algorithm, several
+  times slower. vDSP and Intel IPP only accept powers of two.
+
 */
 aubio_fft_t * new_aubio_fft (uint_t size);
 /** delete FFT object
@@ -58,6 +65,44 @@ aubio_fft_t * new_aubio_fft (uint_t size);
 */
 void del_aubio_fft(aubio_fft_t * s);
 
+/** load FFTW wisdom
+
+  With the FFTW backend, FFT objects take their plans from the wisdom, where
+  they were planned with `FFTW_MEASURE`, or `FFTW_PATIENT` when aubio is
+  compiled with `HAVE_FFTW3_PATIENT`, and estimate the plans it does not have.
+  Loading the wisdom does not run any transform, and can be done when a
+  program or plugin starts.
+
+  \param path wisdom file written by aubio_fft_save_wisdom(), or NULL to load
+  FFTW's system wisdom
+
+  \return 0 if successful, non-zero otherwise, and with other backends
+
+*/
+uint_t aubio_fft_load_wisdom (const char_t * path);
+
+/** save FFTW wisdom
+
+  \param path file to write the wisdom to, including the one loaded with
+  aubio_fft_load_wisdom()
+
+  \return 0 if successful, non-zero otherwise, and with other backends
+
+*/
+uint_t aubio_fft_save_wisdom (const char_t * path);
+
+/** measure the plans missing from the wisdom
+
+  With the FFTW backend, FFT objects created after this is enabled measure
+  the plans the wisdom does not have, which takes from milliseconds to
+  minutes, and adds them to the wisdom. This is meant to generate wisdom
+  offline, before saving it with aubio_fft_save_wisdom().
+
+  \param measure 1 to measure missing plans, 0 to estimate them [default 0]
+
+*/
+void aubio_fft_set_measure (uint_t measure);
+
 /** compute forward FFT
 
   \param s fft object as returned by new_aubio_fft
@@ -92,6 +137,46 @@ void aubio_fft_do_complex (aubio_fft_t *s, const fvec_t * input, fvec_t * compsp
 */
 void aubio_fft_rdo_complex (aubio_fft_t *s, const fvec_t * compspec, fvec_t * output);
 
+/** compute forward FFT in place, in the packed format
+
+  The spectrum is stored as `[ r0, rN, r1, -i1, r2, -i2, ..., rN-1, -iN-1 ]`,
+  where `N` is half the FFT size, the format of the Ooura backend. With Ooura
+  the transform runs directly on the buffer, avoiding the copies and the
+  reordering of aubio_fft_do_complex().
+
+  \param s fft object as returned by new_aubio_fft
+  \param data real input signal, replaced by its packed spectrum
+
+*/
+void aubio_fft_do_packed (aubio_fft_t *s, fvec_t * data);
+/** compute backward (inverse) FFT in place, from the packed format
+
+  \param s fft object as returned by new_aubio_fft
+  \param data packed input spectrum, replaced by the real output signal
+
+*/
+void aubio_fft_rdo_packed (aubio_fft_t *s, fvec_t * data);
+
+/** multiply a packed spectrum by the conjugate of another
+
+  Computes the cross spectrum `conj(a) * b`, whose inverse FFT is the
+  cross-correlation of the two signals. The output can be one of the inputs.
+
+  \param a packed spectrum to conjugate
+  \param b packed spectrum
+  \param out packed output spectrum
+
+*/
+void aubio_fft_packed_mul_conj (const fvec_t * a, const fvec_t * b,
+    fvec_t * out);
+/** compute norm component from a packed spectrum
+
+  \param packed packed input spectrum
+  \param spectrum cvec norm/phas output array
+
+*/
+void aubio_fft_packed_get_norm (const fvec_t * packed, cvec_t * spectrum);
+
 /** convert real/imag spectrum to norm/phas spectrum
 
   \param compspec real/imag input fft array
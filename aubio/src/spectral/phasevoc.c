@@ -24,6 +24,7 @@
 #include "mathutils.h"
 #include "spectral/fft.h"
 #include "spectral/phasevoc.h"
+#include "utils/cache.h"
 
 /** phasevocoder internal object */
 struct _aubio_pvoc_t {
@@ -109,7 +110,7 @@ aubio_pvoc_t * new_aubio_pvoc (uint_t win_s, uint_t hop_s) {
     pv->dataold  = new_fvec  (1);
     pv->synthold = new_fvec (1);
   }
-  pv->w        = new_aubio_window ("hanningz", win_s);
+  pv->w        = aubio_cache_acquire_window ("hanningz", win_s);
 
   pv->hop_s    = hop_s;
   pv->win_s    = win_s;
@@ -144,7 +145,12 @@ beach:
 }
 
 uint_t aubio_pvoc_set_window(aubio_pvoc_t *pv, const char_t *window) {
-  return fvec_set_window(pv->w, (char_t*)window);
+  // the window is shared, so it is swapped rather than overwritten
+  fvec_t *w = aubio_cache_acquire_window((char_t*)window, pv->win_s);
+  if (!w) return AUBIO_FAIL;
+  aubio_cache_release_fvec(pv->w);
+  pv->w = w;
+  return AUBIO_OK;
 }
 
 void del_aubio_pvoc(aubio_pvoc_t *pv) {
@@ -152,7 +158,7 @@ void del_aubio_pvoc(aubio_pvoc_t *pv) {
   del_fvec(pv->synth);
   del_fvec(pv->dataold);
   del_fvec(pv->synthold);
-  del_fvec(pv->w);
+  aubio_cache_release_fvec(pv->w);
   del_aubio_fft(pv->fft);
   AUBIO_FREE(pv);
 }
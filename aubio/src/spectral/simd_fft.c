@@ -0,0 +1,1126 @@
+/*
+  Copyright (C) 2026 the audio-to-cv-pitch-lv2 contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/* Real FFT with vectorised butterflies, used by fft.c when aubio is built
+ * with HAVE_SIMD_FFT, and for the sizes ooura can not do otherwise. It has
+ * the interface and conventions of ooura's rdft: the transform is done in
+ * place, the spectrum is stored as [r0, rN/2, r1, -i1, ...], and the
+ * backward transform is scaled by N / 2.
+ *
+ * A real sequence of size N is transformed as a complex sequence of size
+ * N / 2, its even samples as real parts and its odd samples as imaginary
+ * parts, then split into the spectrum of the real sequence. The complex
+ * transform is a Stockham autosort FFT on separate arrays of real and
+ * imaginary parts, with stages of radix 4 first, then of radix 3 and 5, and
+ * a last stage of radix 2 when needed. Each stage reads and writes
+ * contiguous runs of samples, that are processed with sse2 or avx2 when the
+ * processor has them. Sizes with other prime factors are transformed with
+ * Bluestein's algorithm, as a convolution computed with a transform of a
+ * power of two size. */
+
+#include "aubio_priv.h"
+#include "utils/cache.h"
+
+/* the vector stages are compiled with per function target attributes, so
+ * that the rest of the library keeps the baseline instruction set */
+#if !HAVE_AUBIO_DOUBLE && (defined(__GNUC__) || defined(__clang__)) \
+  && (defined(__x86_64__) || defined(__i386__))
+#define HAVE_SIMD_FFT_X86 1
+#include <immintrin.h>
+#else
+#define HAVE_SIMD_FFT_X86 0
+#endif
+
+/** stage of radix 3, 4 or 5 of a transform of size cur, with stride s */
+typedef void (*aubio_simd_fft_radix_t) (uint_t cur, uint_t s,
+    const smpl_t * tw, const smpl_t * xr, const smpl_t * xi,
+    smpl_t * yr, smpl_t * yi);
+
+/** last radix 2 stage, with stride s */
+typedef void (*aubio_simd_fft_radix2_t) (uint_t s,
+    const smpl_t * xr, const smpl_t * xi, smpl_t * yr, smpl_t * yi);
+
+/** copy between the real sequence a of size 2 n and the complex sequence
+ * xr, xi of size n, conjugated on the way back */
+typedef void (*aubio_simd_fft_pack_t) (uint_t n, const smpl_t * a,
+    smpl_t * xr, smpl_t * xi);
+typedef void (*aubio_simd_fft_unpack_t) (uint_t n, const smpl_t * xr,
+    const smpl_t * xi, smpl_t * a);
+
+/** step between the spectrum a of the real sequence and the spectrum xr, xi
+ * of the complex sequence, with the twiddles c and sn */
+typedef void (*aubio_simd_fft_split_t) (uint_t n, const smpl_t * c,
+    const smpl_t * sn, const smpl_t * xr, const smpl_t * xi, smpl_t * a);
+typedef void (*aubio_simd_fft_merge_t) (uint_t n, const smpl_t * c,
+    const smpl_t * sn, const smpl_t * a, smpl_t * xr, smpl_t * xi);
+
+/** kernels for one instruction set */
+typedef struct
+{
+  aubio_simd_fft_radix_t radix4;
+  aubio_simd_fft_radix_t radix3;
+  aubio_simd_fft_radix_t radix5;
+  aubio_simd_fft_radix2_t radix2;
+  aubio_simd_fft_pack_t pack;
+  aubio_simd_fft_unpack_t unpack;
+  aubio_simd_fft_split_t split;
+  aubio_simd_fft_merge_t merge;
+} aubio_simd_fft_kernels_t;
+
+/** largest number of stages, enough for any uint_t size */
+#define AUBIO_SIMD_FFT_MAX_STAGES 32
+
+typedef struct _aubio_simd_fft_t aubio_simd_fft_t;
+
+struct _aubio_simd_fft_t
+{
+  uint_t size;        /**< size of the real transform */
+  uint_t n;           /**< size of the complex transform, size / 2 */
+  uint_t n_stages;    /**< number of stages, 0 with bluestein */
+  uint_t radix[AUBIO_SIMD_FFT_MAX_STAGES]; /**< radix of each stage */
+  uint_t n_tw;        /**< number of twiddles of all the stages */
+  smpl_t *work;       /**< real and imaginary parts, twice, 4 n */
+  aubio_simd_fft_t *conv; /**< transform of the bluestein convolution */
+  const void *tables; /**< tables below, shared with objects of this size */
+  smpl_t *tw;         /**< w^p .. w^(r-1)p of each stage of radix r */
+  smpl_t *split_re;   /**< cos (2 PI k / size), for k <= n / 2 */
+  smpl_t *split_im;   /**< sin (2 PI k / size), for k <= n / 2 */
+  smpl_t *chirp_re;   /**< cos (PI j^2 / n), for j < n */
+  smpl_t *chirp_im;   /**< - sin (PI j^2 / n), for j < n */
+  smpl_t *kernel_re;  /**< spectrum of the conjugate chirp, over conv n */
+  smpl_t *kernel_im;  /**< imaginary part of the spectrum */
+  const aubio_simd_fft_kernels_t *kernels; /**< kernels for the processor */
+};
+
+aubio_simd_fft_t *new_aubio_simd_fft (uint_t size);
+void del_aubio_simd_fft (aubio_simd_fft_t * s);
+void aubio_simd_fft_rdft (aubio_simd_fft_t * s, int isgn, smpl_t * a);
+
+/* scalar stages, also used for the stages too short to be vectorised */
+
+static void
+aubio_simd_fft_radix4_scalar (uint_t cur, uint_t s, const smpl_t * tw,
+    const smpl_t * xr, const smpl_t * xi, smpl_t * yr, smpl_t * yi)
+{
+  const uint_t m = cur / 4, quarter = s * m;
+  uint_t p, q, i, o;
+  smpl_t t0r, t0i, t1r, t1i, t2r, t2i, t3r, t3i, ur, ui;
+  for (p = 0; p < m; p++) {
+    const smpl_t w1r = tw[p], w1i = tw[m + p];
+    const smpl_t w2r = tw[2 * m + p], w2i = tw[3 * m + p];
+    const smpl_t w3r = tw[4 * m + p], w3i = tw[5 * m + p];
+    for (q = 0; q < s; q++) {
+      i = q + s * p;
+      o = q + 4 * s * p;
+      t0r = xr[i] + xr[i + 2 * quarter];
+      t0i = xi[i] + xi[i + 2 * quarter];
+      t1r = xr[i] - xr[i + 2 * quarter];
+      t1i = xi[i] - xi[i + 2 * quarter];
+      t2r = xr[i + quarter] + xr[i + 3 * quarter];
+      t2i = xi[i + quarter] + xi[i + 3 * quarter];
+      t3r = xr[i + quarter] - xr[i + 3 * quarter];
+      t3i = xi[i + quarter] - xi[i + 3 * quarter];
+      yr[o] = t0r + t2r;
+      yi[o] = t0i + t2i;
+      // (a - c) - i (b - d)
+      ur = t1r + t3i;
+      ui = t1i - t3r;
+      yr[o + s] = ur * w1r - ui * w1i;
+      yi[o + s] = ur * w1i + ui * w1r;
+      ur = t0r - t2r;
+      ui = t0i - t2i;
+      yr[o + 2 * s] = ur * w2r - ui * w2i;
+      yi[o + 2 * s] = ur * w2i + ui * w2r;
+      // (a - c) + i (b - d)
+      ur = t1r - t3i;
+      ui = t1i + t3r;
+      yr[o + 3 * s] = ur * w3r - ui * w3i;
+      yi[o + 3 * s] = ur * w3i + ui * w3r;
+    }
+  }
+}
+
+/* sin (PI / 3), cos and sin of 2 PI / 5 and 4 PI / 5 */
+#define AUBIO_SIMD_FFT_S3 0.86602540378443864676
+#define AUBIO_SIMD_FFT_C51 0.30901699437494742410
+#define AUBIO_SIMD_FFT_C52 -0.80901699437494742410
+#define AUBIO_SIMD_FFT_S51 0.95105651629515357212
+#define AUBIO_SIMD_FFT_S52 0.58778525229247312917
+
+static void
+aubio_simd_fft_radix3_scalar (uint_t cur, uint_t s, const smpl_t * tw,
+    const smpl_t * xr, const smpl_t * xi, smpl_t * yr, smpl_t * yi)
+{
+  const uint_t m = cur / 3, third = s * m;
+  uint_t p, q, i, o;
+  smpl_t t1r, t1i, t2r, t2i, t3r, t3i, ur, ui;
+  for (p = 0; p < m; p++) {
+    const smpl_t w1r = tw[p], w1i = tw[m + p];
+    const smpl_t w2r = tw[2 * m + p], w2i = tw[3 * m + p];
+    for (q = 0; q < s; q++) {
+      i = q + s * p;
+      o = q + 3 * s * p;
+      t1r = xr[i + third] + xr[i + 2 * third];
+      t1i = xi[i + third] + xi[i + 2 * third];
+      t2r = xr[i] - .5 * t1r;
+      t2i = xi[i] - .5 * t1i;
+      t3r = AUBIO_SIMD_FFT_S3 * (xr[i + third] - xr[i + 2 * third]);
+      t3i = AUBIO_SIMD_FFT_S3 * (xi[i + third] - xi[i + 2 * third]);
+      yr[o] = xr[i] + t1r;
+      yi[o] = xi[i] + t1i;
+      // t2 - i t3
+      ur = t2r + t3i;
+      ui = t2i - t3r;
+      yr[o + s] = ur * w1r - ui * w1i;
+      yi[o + s] = ur * w1i + ui * w1r;
+      // t2 + i t3
+      ur = t2r - t3i;
+      ui = t2i + t3r;
+      yr[o + 2 * s] = ur * w2r - ui * w2i;
+      yi[o + 2 * s] = ur * w2i + ui * w2r;
+    }
+  }
+}
+
+static void
+aubio_simd_fft_radix5_scalar (uint_t cur, uint_t s, const smpl_t * tw,
+    const smpl_t * xr, const smpl_t * xi, smpl_t * yr, smpl_t * yi)
+{
+  const uint_t m = cur / 5, fifth = s * m;
+  uint_t p, q, k, i, o;
+  smpl_t t1r, t1i, t2r, t2i, t3r, t3i, t4r, t4i;
+  smpl_t ar[3], ai[3], br[3], bi[3], ur, ui;
+  for (p = 0; p < m; p++) {
+    for (q = 0; q < s; q++) {
+      i = q + s * p;
+      o = q + 5 * s * p;
+      t1r = xr[i + fifth] + xr[i + 4 * fifth];
+      t1i = xi[i + fifth] + xi[i + 4 * fifth];
+      t2r = xr[i + 2 * fifth] + xr[i + 3 * fifth];
+      t2i = xi[i + 2 * fifth] + xi[i + 3 * fifth];
+      t3r = xr[i + fifth] - xr[i + 4 * fifth];
+      t3i = xi[i + fifth] - xi[i + 4 * fifth];
+      t4r = xr[i + 2 * fifth] - xr[i + 3 * fifth];
+      t4i = xi[i + 2 * fifth] - xi[i + 3 * fifth];
+      yr[o] = xr[i] + t1r + t2r;
+      yi[o] = xi[i] + t1i + t2i;
+      ar[1] = xr[i] + AUBIO_SIMD_FFT_C51 * t1r + AUBIO_SIMD_FFT_C52 * t2r;
+      ai[1] = xi[i] + AUBIO_SIMD_FFT_C51 * t1i + AUBIO_SIMD_FFT_C52 * t2i;
+      ar[2] = xr[i] + AUBIO_SIMD_FFT_C52 * t1r + AUBIO_SIMD_FFT_C51 * t2r;
+      ai[2] = xi[i] + AUBIO_SIMD_FFT_C52 * t1i + AUBIO_SIMD_FFT_C51 * t2i;
+      br[1] = AUBIO_SIMD_FFT_S51 * t3r + AUBIO_SIMD_FFT_S52 * t4r;
+      bi[1] = AUBIO_SIMD_FFT_S51 * t3i + AUBIO_SIMD_FFT_S52 * t4i;
+      br[2] = AUBIO_SIMD_FFT_S52 * t3r - AUBIO_SIMD_FFT_S51 * t4r;
+      bi[2] = AUBIO_SIMD_FFT_S52 * t3i - AUBIO_SIMD_FFT_S51 * t4i;
+      for (k = 1; k < 5; k++) {
+        // a - i b for the bins 1 and 2, a + i b for their mirrors 4 and 3
+        const uint_t j = k < 3 ? k : 5 - k;
+        const smpl_t w_r = tw[2 * (k - 1) * m + p];
+        const smpl_t w_i = tw[(2 * k - 1) * m + p];
+        ur = k < 3 ? ar[j] + bi[j] : ar[j] - bi[j];
+        ui = k < 3 ? ai[j] - br[j] : ai[j] + br[j];
+        yr[o + k * s] = ur * w_r - ui * w_i;
+        yi[o + k * s] = ur * w_i + ui * w_r;
+      }
+    }
+  }
+}
+
+static void
+aubio_simd_fft_radix2_scalar (uint_t s, const smpl_t * xr, const smpl_t * xi,
+    smpl_t * yr, smpl_t * yi)
+{
+  uint_t q;
+  for (q = 0; q < s; q++) {
+    yr[q] = xr[q] + xr[q + s];
+    yi[q] = xi[q] + xi[q + s];
+    yr[q + s] = xr[q] - xr[q + s];
+    yi[q + s] = xi[q] - xi[q + s];
+  }
+}
+
+static void
+aubio_simd_fft_pack_scalar (uint_t n, const smpl_t * a, smpl_t * xr,
+    smpl_t * xi)
+{
+  uint_t j;
+  for (j = 0; j < n; j++) {
+    xr[j] = a[2 * j];
+    xi[j] = a[2 * j + 1];
+  }
+}
+
+static void
+aubio_simd_fft_unpack_scalar (uint_t n, const smpl_t * xr, const smpl_t * xi,
+    smpl_t * a)
+{
+  uint_t j;
+  for (j = 0; j < n; j++) {
+    a[2 * j] = xr[j];
+    a[2 * j + 1] = - xi[j];
+  }
+}
+
+/* split the bins k and n - k of the spectrum Z of the complex sequence into
+ * those of the real sequence, for k from start to n / 2, with
+ *
+ *   X[k] = E[k] - i w^k O[k], w = exp (-2 i PI / size),
+ *   E[k] = (Z[k] + conj Z[n-k]) / 2, O[k] = (Z[k] - conj Z[n-k]) / 2 */
+static inline void
+aubio_simd_fft_split_bins (uint_t n, uint_t start, const smpl_t * c,
+    const smpl_t * sn, const smpl_t * zr, const smpl_t * zi, smpl_t * a)
+{
+  smpl_t er, ei, dr, di, vr, vi;
+  uint_t k;
+  for (k = start; k <= n / 2; k++) {
+    er = .5 * (zr[k] + zr[n - k]);
+    ei = .5 * (zi[k] - zi[n - k]);
+    dr = .5 * (zr[k] - zr[n - k]);
+    di = .5 * (zi[k] + zi[n - k]);
+    // v = w^k O[k]
+    vr = c[k] * dr + sn[k] * di;
+    vi = c[k] * di - sn[k] * dr;
+    a[2 * k] = er + vi;
+    a[2 * k + 1] = vr - ei;
+    a[2 * (n - k)] = er - vi;
+    a[2 * (n - k) + 1] = ei + vr;
+  }
+}
+
+/* merge the bins k and n - k of the spectrum of the real sequence back into
+ * the conjugate of those of Z, for k from start to n / 2, with
+ *
+ *   Z[k] = E[k] + i w^-k D[k],
+ *   E[k] = (X[k] + conj X[n-k]) / 2, D[k] = (X[k] - conj X[n-k]) / 2 */
+static inline void
+aubio_simd_fft_merge_bins (uint_t n, uint_t start, const smpl_t * c,
+    const smpl_t * sn, const smpl_t * a, smpl_t * zr, smpl_t * zi)
+{
+  smpl_t er, ei, dr, di, vr, vi;
+  uint_t k;
+  for (k = start; k <= n / 2; k++) {
+    er = .5 * (a[2 * k] + a[2 * (n - k)]);
+    ei = .5 * (a[2 * (n - k) + 1] - a[2 * k + 1]);
+    dr = .5 * (a[2 * k] - a[2 * (n - k)]);
+    di = - .5 * (a[2 * k + 1] + a[2 * (n - k) + 1]);
+    // v = w^-k D[k]
+    vr = c[k] * dr - sn[k] * di;
+    vi = c[k] * di + sn[k] * dr;
+    zr[k] = er - vi;
+    zi[k] = - (ei + vr);
+    zr[n - k] = er + vi;
+    zi[n - k] = ei - vr;
+  }
+}
+
+static void
+aubio_simd_fft_split_scalar (uint_t n, const smpl_t * c, const smpl_t * sn,
+    const smpl_t * zr, const smpl_t * zi, smpl_t * a)
+{
+  a[0] = zr[0] + zi[0];
+  a[1] = zr[0] - zi[0];
+  aubio_simd_fft_split_bins (n, 1, c, sn, zr, zi, a);
+}
+
+static void
+aubio_simd_fft_merge_scalar (uint_t n, const smpl_t * c, const smpl_t * sn,
+    const smpl_t * a, smpl_t * zr, smpl_t * zi)
+{
+  zr[0] = .5 * (a[0] + a[1]);
+  zi[0] = - .5 * (a[0] - a[1]);
+  aubio_simd_fft_merge_bins (n, 1, c, sn, a, zr, zi);
+}
+
+static const aubio_simd_fft_kernels_t aubio_simd_fft_scalar = {
+  aubio_simd_fft_radix4_scalar, aubio_simd_fft_radix3_scalar,
+  aubio_simd_fft_radix5_scalar, aubio_simd_fft_radix2_scalar,
+  aubio_simd_fft_pack_scalar, aubio_simd_fft_unpack_scalar,
+  aubio_simd_fft_split_scalar, aubio_simd_fft_merge_scalar
+};
+
+#if HAVE_SIMD_FFT_X86
+
+/* radix 4 butterfly of a, b, c, d in r[0..3] and i[0..3], twiddled by
+ * w^p, w^2p, w^3p in wr[0..2] and wi[0..2], in place */
+__attribute__((target("sse2")))
+static inline void
+aubio_simd_fft_bfly4_sse2 (__m128 * r, __m128 * i, const __m128 * wr,
+    const __m128 * wi)
+{
+  const __m128 t0r = _mm_add_ps (r[0], r[2]), t0i = _mm_add_ps (i[0], i[2]);
+  const __m128 t1r = _mm_sub_ps (r[0], r[2]), t1i = _mm_sub_ps (i[0], i[2]);
+  const __m128 t2r = _mm_add_ps (r[1], r[3]), t2i = _mm_add_ps (i[1], i[3]);
+  const __m128 t3r = _mm_sub_ps (r[1], r[3]), t3i = _mm_sub_ps (i[1], i[3]);
+  __m128 ur, ui;
+  r[0] = _mm_add_ps (t0r, t2r);
+  i[0] = _mm_add_ps (t0i, t2i);
+  ur = _mm_add_ps (t1r, t3i);
+  ui = _mm_sub_ps (t1i, t3r);
+  r[1] = _mm_sub_ps (_mm_mul_ps (ur, wr[0]), _mm_mul_ps (ui, wi[0]));
+  i[1] = _mm_add_ps (_mm_mul_ps (ur, wi[0]), _mm_mul_ps (ui, wr[0]));
+  ur = _mm_sub_ps (t0r, t2r);
+  ui = _mm_sub_ps (t0i, t2i);
+  r[2] = _mm_sub_ps (_mm_mul_ps (ur, wr[1]), _mm_mul_ps (ui, wi[1]));
+  i[2] = _mm_add_ps (_mm_mul_ps (ur, wi[1]), _mm_mul_ps (ui, wr[1]));
+  ur = _mm_sub_ps (t1r, t3i);
+  ui = _mm_add_ps (t1i, t3r);
+  r[3] = _mm_sub_ps (_mm_mul_ps (ur, wr[2]), _mm_mul_ps (ui, wi[2]));
+  i[3] = _mm_add_ps (_mm_mul_ps (ur, wi[2]), _mm_mul_ps (ui, wr[2]));
+}
+
+__attribute__((target("sse2")))
+static void
+aubio_simd_fft_radix4_sse2 (uint_t cur, uint_t s, const smpl_t * tw,
+    const smpl_t * xr, const smpl_t * xi, smpl_t * yr, smpl_t * yi)
+{
+  const uint_t m = cur / 4, quarter = s * m;
+  __m128 r[4], i[4], wr[3], wi[3];
+  uint_t p, q, k;
+  if (s == 1 && m % 4 == 0) {
+    // first stage, four consecutive p at a time, each with its own
+    // twiddles, and transposed so that the outputs of each p are stored
+    // together
+    for (p = 0; p < m; p += 4) {
+      for (k = 0; k < 4; k++) {
+        r[k] = _mm_loadu_ps (xr + p + k * quarter);
+        i[k] = _mm_loadu_ps (xi + p + k * quarter);
+      }
+      for (k = 0; k < 3; k++) {
+        wr[k] = _mm_loadu_ps (tw + 2 * k * m + p);
+        wi[k] = _mm_loadu_ps (tw + (2 * k + 1) * m + p);
+      }
+      aubio_simd_fft_bfly4_sse2 (r, i, wr, wi);
+      _MM_TRANSPOSE4_PS (r[0], r[1], r[2], r[3]);
+      _MM_TRANSPOSE4_PS (i[0], i[1], i[2], i[3]);
+      for (k = 0; k < 4; k++) {
+        _mm_storeu_ps (yr + 4 * p + 4 * k, r[k]);
+        _mm_storeu_ps (yi + 4 * p + 4 * k, i[k]);
+      }
+    }
+  } else if (s % 4 == 0) {
+    // later stages, four consecutive q at a time, sharing their twiddles
+    for (p = 0; p < m; p++) {
+      for (k = 0; k < 3; k++) {
+        wr[k] = _mm_set1_ps (tw[2 * k * m + p]);
+        wi[k] = _mm_set1_ps (tw[(2 * k + 1) * m + p]);
+      }
+      for (q = 0; q < s; q += 4) {
+        for (k = 0; k < 4; k++) {
+          r[k] = _mm_loadu_ps (xr + q + s * p + k * quarter);
+          i[k] = _mm_loadu_ps (xi + q + s * p + k * quarter);
+        }
+        aubio_simd_fft_bfly4_sse2 (r, i, wr, wi);
+        for (k = 0; k < 4; k++) {
+          _mm_storeu_ps (yr + q + s * (4 * p + k), r[k]);
+          _mm_storeu_ps (yi + q + s * (4 * p + k), i[k]);
+        }
+      }
+    }
+  } else {
+    aubio_simd_fft_radix4_scalar (cur, s, tw, xr, xi, yr, yi);
+  }
+}
+
+__attribute__((target("sse2")))
+static void
+aubio_simd_fft_radix2_sse2 (uint_t s, const smpl_t * xr, const smpl_t * xi,
+    smpl_t * yr, smpl_t * yi)
+{
+  uint_t q;
+  __m128 ar, ai, br, bi;
+  for (q = 0; q + 4 <= s; q += 4) {
+    ar = _mm_loadu_ps (xr + q);
+    ai = _mm_loadu_ps (xi + q);
+    br = _mm_loadu_ps (xr + q + s);
+    bi = _mm_loadu_ps (xi + q + s);
+    _mm_storeu_ps (yr + q, _mm_add_ps (ar, br));
+    _mm_storeu_ps (yi + q, _mm_add_ps (ai, bi));
+    _mm_storeu_ps (yr + q + s, _mm_sub_ps (ar, br));
+    _mm_storeu_ps (yi + q + s, _mm_sub_ps (ai, bi));
+  }
+  for (; q < s; q++) {
+    yr[q] = xr[q] + xr[q + s];
+    yi[q] = xi[q] + xi[q + s];
+    yr[q + s] = xr[q] - xr[q + s];
+    yi[q + s] = xi[q] - xi[q + s];
+  }
+}
+
+/* radix 3 butterfly of a, b, c in r[0..2] and i[0..2], twiddled by w^p,
+ * w^2p in wr[0..1] and wi[0..1], in place */
+__attribute__((target("sse2")))
+static inline void
+aubio_simd_fft_bfly3_sse2 (__m128 * r, __m128 * i, const __m128 * wr,
+    const __m128 * wi)
+{
+  const __m128 half = _mm_set1_ps (.5), s3 = _mm_set1_ps (AUBIO_SIMD_FFT_S3);
+  const __m128 t1r = _mm_add_ps (r[1], r[2]), t1i = _mm_add_ps (i[1], i[2]);
+  const __m128 t2r = _mm_sub_ps (r[0], _mm_mul_ps (half, t1r));
+  const __m128 t2i = _mm_sub_ps (i[0], _mm_mul_ps (half, t1i));
+  const __m128 t3r = _mm_mul_ps (s3, _mm_sub_ps (r[1], r[2]));
+  const __m128 t3i = _mm_mul_ps (s3, _mm_sub_ps (i[1], i[2]));
+  __m128 ur, ui;
+  r[0] = _mm_add_ps (r[0], t1r);
+  i[0] = _mm_add_ps (i[0], t1i);
+  ur = _mm_add_ps (t2r, t3i);
+  ui = _mm_sub_ps (t2i, t3r);
+  r[1] = _mm_sub_ps (_mm_mul_ps (ur, wr[0]), _mm_mul_ps (ui, wi[0]));
+  i[1] = _mm_add_ps (_mm_mul_ps (ur, wi[0]), _mm_mul_ps (ui, wr[0]));
+  ur = _mm_sub_ps (t2r, t3i);
+  ui = _mm_add_ps (t2i, t3r);
+  r[2] = _mm_sub_ps (_mm_mul_ps (ur, wr[1]), _mm_mul_ps (ui, wi[1]));
+  i[2] = _mm_add_ps (_mm_mul_ps (ur, wi[1]), _mm_mul_ps (ui, wr[1]));
+}
+
+/* radix 5 butterfly of r[0..4] and i[0..4], twiddled by w^p .. w^4p in
+ * wr[0..3] and wi[0..3], in place */
+__attribute__((target("sse2")))
+static inline void
+aubio_simd_fft_bfly5_sse2 (__m128 * r, __m128 * i, const __m128 * wr,
+    const __m128 * wi)
+{
+  const __m128 c1 = _mm_set1_ps (AUBIO_SIMD_FFT_C51);
+  const __m128 c2 = _mm_set1_ps (AUBIO_SIMD_FFT_C52);
+  const __m128 s1 = _mm_set1_ps (AUBIO_SIMD_FFT_S51);
+  const __m128 s2 = _mm_set1_ps (AUBIO_SIMD_FFT_S52);
+  const __m128 t1r = _mm_add_ps (r[1], r[4]), t1i = _mm_add_ps (i[1], i[4]);
+  const __m128 t2r = _mm_add_ps (r[2], r[3]), t2i = _mm_add_ps (i[2], i[3]);
+  const __m128 t3r = _mm_sub_ps (r[1], r[4]), t3i = _mm_sub_ps (i[1], i[4]);
+  const __m128 t4r = _mm_sub_ps (r[2], r[3]), t4i = _mm_sub_ps (i[2], i[3]);
+  const __m128 a1r = _mm_add_ps (r[0],
+      _mm_add_ps (_mm_mul_ps (c1, t1r), _mm_mul_ps (c2, t2r)));
+  const __m128 a1i = _mm_add_ps (i[0],
+      _mm_add_ps (_mm_mul_ps (c1, t1i), _mm_mul_ps (c2, t2i)));
+  const __m128 a2r = _mm_add_ps (r[0],
+      _mm_add_ps (_mm_mul_ps (c2, t1r), _mm_mul_ps (c1, t2r)));
+  const __m128 a2i = _mm_add_ps (i[0],
+      _mm_add_ps (_mm_mul_ps (c2, t1i), _mm_mul_ps (c1, t2i)));
+  const __m128 b1r = _mm_add_ps (_mm_mul_ps (s1, t3r), _mm_mul_ps (s2, t4r));
+  const __m128 b1i = _mm_add_ps (_mm_mul_ps (s1, t3i), _mm_mul_ps (s2, t4i));
+  const __m128 b2r = _mm_sub_ps (_mm_mul_ps (s2, t3r), _mm_mul_ps (s1, t4r));
+  const __m128 b2i = _mm_sub_ps (_mm_mul_ps (s2, t3i), _mm_mul_ps (s1, t4i));
+  __m128 ur[4], ui[4];
+  uint_t k;
+  r[0] = _mm_add_ps (r[0], _mm_add_ps (t1r, t2r));
+  i[0] = _mm_add_ps (i[0], _mm_add_ps (t1i, t2i));
+  // a - i b for the bins 1 and 2, a + i b for their mirrors 4 and 3
+  ur[0] = _mm_add_ps (a1r, b1i);
+  ui[0] = _mm_sub_ps (a1i, b1r);
+  ur[1] = _mm_add_ps (a2r, b2i);
+  ui[1] = _mm_sub_ps (a2i, b2r);
+  ur[2] = _mm_sub_ps (a2r, b2i);
+  ui[2] = _mm_add_ps (a2i, b2r);
+  ur[3] = _mm_sub_ps (a1r, b1i);
+  ui[3] = _mm_add_ps (a1i, b1r);
+  for (k = 0; k < 4; k++) {
+    r[k + 1] = _mm_sub_ps (_mm_mul_ps (ur[k], wr[k]), _mm_mul_ps (ui[k], wi[k]));
+    i[k + 1] = _mm_add_ps (_mm_mul_ps (ur[k], wi[k]), _mm_mul_ps (ui[k], wr[k]));
+  }
+}
+
+/* radix 3 and 5 stages, four consecutive q at a time sharing their
+ * twiddles, as the later radix 4 stages; the first stage, with s = 1, only
+ * happens for sizes with no factor 4 and is left scalar */
+__attribute__((target("sse2")))
+static void
+aubio_simd_fft_radix3_sse2 (uint_t cur, uint_t s, const smpl_t * tw,
+    const smpl_t * xr, const smpl_t * xi, smpl_t * yr, smpl_t * yi)
+{
+  const uint_t m = cur / 3, third = s * m;
+  __m128 r[3], i[3], wr[2], wi[2];
+  uint_t p, q, k;
+  if (s % 4 != 0) {
+    aubio_simd_fft_radix3_scalar (cur, s, tw, xr, xi, yr, yi);
+    return;
+  }
+  for (p = 0; p < m; p++) {
+    for (k = 0; k < 2; k++) {
+      wr[k] = _mm_set1_ps (tw[2 * k * m + p]);
+      wi[k] = _mm_set1_ps (tw[(2 * k + 1) * m + p]);
+    }
+    for (q = 0; q < s; q += 4) {
+      for (k = 0; k < 3; k++) {
+        r[k] = _mm_loadu_ps (xr + q + s * p + k * third);
+        i[k] = _mm_loadu_ps (xi + q + s * p + k * third);
+      }
+      aubio_simd_fft_bfly3_sse2 (r, i, wr, wi);
+      for (k = 0; k < 3; k++) {
+        _mm_storeu_ps (yr + q + s * (3 * p + k), r[k]);
+        _mm_storeu_ps (yi + q + s * (3 * p + k), i[k]);
+      }
+    }
+  }
+}
+
+__attribute__((target("sse2")))
+static void
+aubio_simd_fft_radix5_sse2 (uint_t cur, uint_t s, const smpl_t * tw,
+    const smpl_t * xr, const smpl_t * xi, smpl_t * yr, smpl_t * yi)
+{
+  const uint_t m = cur / 5, fifth = s * m;
+  __m128 r[5], i[5], wr[4], wi[4];
+  uint_t p, q, k;
+  if (s % 4 != 0) {
+    aubio_simd_fft_radix5_scalar (cur, s, tw, xr, xi, yr, yi);
+    return;
+  }
+  for (p = 0; p < m; p++) {
+    for (k = 0; k < 4; k++) {
+      wr[k] = _mm_set1_ps (tw[2 * k * m + p]);
+      wi[k] = _mm_set1_ps (tw[(2 * k + 1) * m + p]);
+    }
+    for (q = 0; q < s; q += 4) {
+      for (k = 0; k < 5; k++) {
+        r[k] = _mm_loadu_ps (xr + q + s * p + k * fifth);
+        i[k] = _mm_loadu_ps (xi + q + s * p + k * fifth);
+      }
+      aubio_simd_fft_bfly5_sse2 (r, i, wr, wi);
+      for (k = 0; k < 5; k++) {
+        _mm_storeu_ps (yr + q + s * (5 * p + k), r[k]);
+        _mm_storeu_ps (yi + q + s * (5 * p + k), i[k]);
+      }
+    }
+  }
+}
+
+/* reverse the order of the four samples of v */
+#define AUBIO_SIMD_FFT_REVERSE(v) _mm_shuffle_ps (v, v, _MM_SHUFFLE (0, 1, 2, 3))
+
+__attribute__((target("sse2")))
+static void
+aubio_simd_fft_pack_sse2 (uint_t n, const smpl_t * a, smpl_t * xr,
+    smpl_t * xi)
+{
+  __m128 v0, v1;
+  uint_t j;
+  for (j = 0; j + 4 <= n; j += 4) {
+    v0 = _mm_loadu_ps (a + 2 * j);
+    v1 = _mm_loadu_ps (a + 2 * j + 4);
+    _mm_storeu_ps (xr + j, _mm_shuffle_ps (v0, v1, _MM_SHUFFLE (2, 0, 2, 0)));
+    _mm_storeu_ps (xi + j, _mm_shuffle_ps (v0, v1, _MM_SHUFFLE (3, 1, 3, 1)));
+  }
+  aubio_simd_fft_pack_scalar (n - j, a + 2 * j, xr + j, xi + j);
+}
+
+__attribute__((target("sse2")))
+static void
+aubio_simd_fft_unpack_sse2 (uint_t n, const smpl_t * xr, const smpl_t * xi,
+    smpl_t * a)
+{
+  const __m128 sign = _mm_set1_ps (-0.);
+  __m128 re, im;
+  uint_t j;
+  for (j = 0; j + 4 <= n; j += 4) {
+    re = _mm_loadu_ps (xr + j);
+    im = _mm_xor_ps (_mm_loadu_ps (xi + j), sign);
+    _mm_storeu_ps (a + 2 * j, _mm_unpacklo_ps (re, im));
+    _mm_storeu_ps (a + 2 * j + 4, _mm_unpackhi_ps (re, im));
+  }
+  aubio_simd_fft_unpack_scalar (n - j, xr + j, xi + j, a + 2 * j);
+}
+
+/* four bins k at a time, with the four bins n - k loaded and stored in
+ * reverse order */
+__attribute__((target("sse2")))
+static void
+aubio_simd_fft_split_sse2 (uint_t n, const smpl_t * c, const smpl_t * sn,
+    const smpl_t * zr, const smpl_t * zi, smpl_t * a)
+{
+  const __m128 half = _mm_set1_ps (.5);
+  __m128 zrk, zik, zrm, zim, wr, wi, er, ei, dr, di, vr, vi, xr, xi;
+  uint_t k, m;
+  a[0] = zr[0] + zi[0];
+  a[1] = zr[0] - zi[0];
+  for (k = 1; k + 4 <= n / 2; k += 4) {
+    m = n - k - 3;
+    zrk = _mm_loadu_ps (zr + k);
+    zik = _mm_loadu_ps (zi + k);
+    zrm = _mm_loadu_ps (zr + m);
+    zim = _mm_loadu_ps (zi + m);
+    zrm = AUBIO_SIMD_FFT_REVERSE (zrm);
+    zim = AUBIO_SIMD_FFT_REVERSE (zim);
+    wr = _mm_loadu_ps (c + k);
+    wi = _mm_loadu_ps (sn + k);
+    er = _mm_mul_ps (half, _mm_add_ps (zrk, zrm));
+    ei = _mm_mul_ps (half, _mm_sub_ps (zik, zim));
+    dr = _mm_mul_ps (half, _mm_sub_ps (zrk, zrm));
+    di = _mm_mul_ps (half, _mm_add_ps (zik, zim));
+    vr = _mm_add_ps (_mm_mul_ps (wr, dr), _mm_mul_ps (wi, di));
+    vi = _mm_sub_ps (_mm_mul_ps (wr, di), _mm_mul_ps (wi, dr));
+    xr = _mm_add_ps (er, vi);
+    xi = _mm_sub_ps (vr, ei);
+    _mm_storeu_ps (a + 2 * k, _mm_unpacklo_ps (xr, xi));
+    _mm_storeu_ps (a + 2 * k + 4, _mm_unpackhi_ps (xr, xi));
+    xr = _mm_sub_ps (er, vi);
+    xi = _mm_add_ps (ei, vr);
+    xr = AUBIO_SIMD_FFT_REVERSE (xr);
+    xi = AUBIO_SIMD_FFT_REVERSE (xi);
+    _mm_storeu_ps (a + 2 * m, _mm_unpacklo_ps (xr, xi));
+    _mm_storeu_ps (a + 2 * m + 4, _mm_unpackhi_ps (xr, xi));
+  }
+  aubio_simd_fft_split_bins (n, k, c, sn, zr, zi, a);
+}
+
+__attribute__((target("sse2")))
+static void
+aubio_simd_fft_merge_sse2 (uint_t n, const smpl_t * c, const smpl_t * sn,
+    const smpl_t * a, smpl_t * zr, smpl_t * zi)
+{
+  const __m128 half = _mm_set1_ps (.5), sign = _mm_set1_ps (-0.);
+  __m128 v0, v1, ark, aik, arm, aim, wr, wi, er, ei, dr, di, vr, vi;
+  uint_t k, m;
+  zr[0] = .5 * (a[0] + a[1]);
+  zi[0] = - .5 * (a[0] - a[1]);
+  for (k = 1; k + 4 <= n / 2; k += 4) {
+    m = n - k - 3;
+    v0 = _mm_loadu_ps (a + 2 * k);
+    v1 = _mm_loadu_ps (a + 2 * k + 4);
+    ark = _mm_shuffle_ps (v0, v1, _MM_SHUFFLE (2, 0, 2, 0));
+    aik = _mm_shuffle_ps (v0, v1, _MM_SHUFFLE (3, 1, 3, 1));
+    v0 = _mm_loadu_ps (a + 2 * m);
+    v1 = _mm_loadu_ps (a + 2 * m + 4);
+    arm = _mm_shuffle_ps (v0, v1, _MM_SHUFFLE (2, 0, 2, 0));
+    aim = _mm_shuffle_ps (v0, v1, _MM_SHUFFLE (3, 1, 3, 1));
+    arm = AUBIO_SIMD_FFT_REVERSE (arm);
+    aim = AUBIO_SIMD_FFT_REVERSE (aim);
+    wr = _mm_loadu_ps (c + k);
+    wi = _mm_loadu_ps (sn + k);
+    er = _mm_mul_ps (half, _mm_add_ps (ark, arm));
+    ei = _mm_mul_ps (half, _mm_sub_ps (aim, aik));
+    dr = _mm_mul_ps (half, _mm_sub_ps (ark, arm));
+    di = _mm_xor_ps (_mm_mul_ps (half, _mm_add_ps (aik, aim)), sign);
+    vr = _mm_sub_ps (_mm_mul_ps (wr, dr), _mm_mul_ps (wi, di));
+    vi = _mm_add_ps (_mm_mul_ps (wr, di), _mm_mul_ps (wi, dr));
+    _mm_storeu_ps (zr + k, _mm_sub_ps (er, vi));
+    _mm_storeu_ps (zi + k, _mm_xor_ps (_mm_add_ps (ei, vr), sign));
+    v0 = _mm_add_ps (er, vi);
+    v1 = _mm_sub_ps (ei, vr);
+    _mm_storeu_ps (zr + m, AUBIO_SIMD_FFT_REVERSE (v0));
+    _mm_storeu_ps (zi + m, AUBIO_SIMD_FFT_REVERSE (v1));
+  }
+  aubio_simd_fft_merge_bins (n, k, c, sn, a, zr, zi);
+}
+
+__attribute__((target("avx2,fma")))
+static inline void
+aubio_simd_fft_bfly4_avx2 (__m256 * r, __m256 * i, const __m256 * wr,
+    const __m256 * wi)
+{
+  const __m256 t0r = _mm256_add_ps (r[0], r[2]);
+  const __m256 t0i = _mm256_add_ps (i[0], i[2]);
+  const __m256 t1r = _mm256_sub_ps (r[0], r[2]);
+  const __m256 t1i = _mm256_sub_ps (i[0], i[2]);
+  const __m256 t2r = _mm256_add_ps (r[1], r[3]);
+  const __m256 t2i = _mm256_add_ps (i[1], i[3]);
+  const __m256 t3r = _mm256_sub_ps (r[1], r[3]);
+  const __m256 t3i = _mm256_sub_ps (i[1], i[3]);
+  __m256 ur, ui;
+  r[0] = _mm256_add_ps (t0r, t2r);
+  i[0] = _mm256_add_ps (t0i, t2i);
+  ur = _mm256_add_ps (t1r, t3i);
+  ui = _mm256_sub_ps (t1i, t3r);
+  r[1] = _mm256_fmsub_ps (ur, wr[0], _mm256_mul_ps (ui, wi[0]));
+  i[1] = _mm256_fmadd_ps (ur, wi[0], _mm256_mul_ps (ui, wr[0]));
+  ur = _mm256_sub_ps (t0r, t2r);
+  ui = _mm256_sub_ps (t0i, t2i);
+  r[2] = _mm256_fmsub_ps (ur, wr[1], _mm256_mul_ps (ui, wi[1]));
+  i[2] = _mm256_fmadd_ps (ur, wi[1], _mm256_mul_ps (ui, wr[1]));
+  ur = _mm256_sub_ps (t1r, t3i);
+  ui = _mm256_add_ps (t1i, t3r);
+  r[3] = _mm256_fmsub_ps (ur, wr[2], _mm256_mul_ps (ui, wi[2]));
+  i[3] = _mm256_fmadd_ps (ur, wi[2], _mm256_mul_ps (ui, wr[2]));
+}
+
+/* transpose the 4x4 blocks of each 128 bit lane of v[0..3], then store the
+ * outputs of the eight consecutive p at y */
+__attribute__((target("avx2,fma")))
+static inline void
+aubio_simd_fft_store4_avx2 (smpl_t * y, const __m256 * v)
+{
+  const __m256 t0 = _mm256_unpacklo_ps (v[0], v[1]);
+  const __m256 t1 = _mm256_unpackhi_ps (v[0], v[1]);
+  const __m256 t2 = _mm256_unpacklo_ps (v[2], v[3]);
+  const __m256 t3 = _mm256_unpackhi_ps (v[2], v[3]);
+  const __m256 p0 = _mm256_shuffle_ps (t0, t2, _MM_SHUFFLE (1, 0, 1, 0));
+  const __m256 p1 = _mm256_shuffle_ps (t0, t2, _MM_SHUFFLE (3, 2, 3, 2));
+  const __m256 p2 = _mm256_shuffle_ps (t1, t3, _MM_SHUFFLE (1, 0, 1, 0));
+  const __m256 p3 = _mm256_shuffle_ps (t1, t3, _MM_SHUFFLE (3, 2, 3, 2));
+  _mm256_storeu_ps (y, _mm256_permute2f128_ps (p0, p1, 0x20));
+  _mm256_storeu_ps (y + 8, _mm256_permute2f128_ps (p2, p3, 0x20));
+  _mm256_storeu_ps (y + 16, _mm256_permute2f128_ps (p0, p1, 0x31));
+  _mm256_storeu_ps (y + 24, _mm256_permute2f128_ps (p2, p3, 0x31));
+}
+
+__attribute__((target("avx2,fma")))
+static void
+aubio_simd_fft_radix4_avx2 (uint_t cur, uint_t s, const smpl_t * tw,
+    const smpl_t * xr, const smpl_t * xi, smpl_t * yr, smpl_t * yi)
+{
+  const uint_t m = cur / 4, quarter = s * m;
+  __m256 r[4], i[4], wr[3], wi[3];
+  uint_t p, q, k;
+  if (s == 1 && m % 8 == 0) {
+    for (p = 0; p < m; p += 8) {
+      for (k = 0; k < 4; k++) {
+        r[k] = _mm256_loadu_ps (xr + p + k * quarter);
+        i[k] = _mm256_loadu_ps (xi + p + k * quarter);
+      }
+      for (k = 0; k < 3; k++) {
+        wr[k] = _mm256_loadu_ps (tw + 2 * k * m + p);
+        wi[k] = _mm256_loadu_ps (tw + (2 * k + 1) * m + p);
+      }
+      aubio_simd_fft_bfly4_avx2 (r, i, wr, wi);
+      aubio_simd_fft_store4_avx2 (yr + 4 * p, r);
+      aubio_simd_fft_store4_avx2 (yi + 4 * p, i);
+    }
+  } else if (s % 8 == 0) {
+    for (p = 0; p < m; p++) {
+      for (k = 0; k < 3; k++) {
+        wr[k] = _mm256_set1_ps (tw[2 * k * m + p]);
+        wi[k] = _mm256_set1_ps (tw[(2 * k + 1) * m + p]);
+      }
+      for (q = 0; q < s; q += 8) {
+        for (k = 0; k < 4; k++) {
+          r[k] = _mm256_loadu_ps (xr + q + s * p + k * quarter);
+          i[k] = _mm256_loadu_ps (xi + q + s * p + k * quarter);
+        }
+        aubio_simd_fft_bfly4_avx2 (r, i, wr, wi);
+        for (k = 0; k < 4; k++) {
+          _mm256_storeu_ps (yr + q + s * (4 * p + k), r[k]);
+          _mm256_storeu_ps (yi + q + s * (4 * p + k), i[k]);
+        }
+      }
+    }
+  } else {
+    // too short for eight lanes
+    aubio_simd_fft_radix4_sse2 (cur, s, tw, xr, xi, yr, yi);
+  }
+}
+
+__attribute__((target("avx2,fma")))
+static void
+aubio_simd_fft_radix2_avx2 (uint_t s, const smpl_t * xr, const smpl_t * xi,
+    smpl_t * yr, smpl_t * yi)
+{
+  uint_t q;
+  __m256 ar, ai, br, bi;
+  if (s % 8 != 0) {
+    aubio_simd_fft_radix2_sse2 (s, xr, xi, yr, yi);
+    return;
+  }
+  for (q = 0; q < s; q += 8) {
+    ar = _mm256_loadu_ps (xr + q);
+    ai = _mm256_loadu_ps (xi + q);
+    br = _mm256_loadu_ps (xr + q + s);
+    bi = _mm256_loadu_ps (xi + q + s);
+    _mm256_storeu_ps (yr + q, _mm256_add_ps (ar, br));
+    _mm256_storeu_ps (yi + q, _mm256_add_ps (ai, bi));
+    _mm256_storeu_ps (yr + q + s, _mm256_sub_ps (ar, br));
+    _mm256_storeu_ps (yi + q + s, _mm256_sub_ps (ai, bi));
+  }
+}
+
+static const aubio_simd_fft_kernels_t aubio_simd_fft_sse2 = {
+  aubio_simd_fft_radix4_sse2, aubio_simd_fft_radix3_sse2,
+  aubio_simd_fft_radix5_sse2, aubio_simd_fft_radix2_sse2,
+  aubio_simd_fft_pack_sse2, aubio_simd_fft_unpack_sse2,
+  aubio_simd_fft_split_sse2, aubio_simd_fft_merge_sse2
+};
+
+// the steps on the real sequence are short next to the stages, and keep
+// the sse2 versions, as do the few radix 3 and 5 stages
+static const aubio_simd_fft_kernels_t aubio_simd_fft_avx2 = {
+  aubio_simd_fft_radix4_avx2, aubio_simd_fft_radix3_sse2,
+  aubio_simd_fft_radix5_sse2, aubio_simd_fft_radix2_avx2,
+  aubio_simd_fft_pack_sse2, aubio_simd_fft_unpack_sse2,
+  aubio_simd_fft_split_sse2, aubio_simd_fft_merge_sse2
+};
+
+#endif /* HAVE_SIMD_FFT_X86 */
+
+static void aubio_simd_fft_cfft (aubio_simd_fft_t * s, smpl_t ** re,
+    smpl_t ** im);
+
+/* plan the transform of the complex sequence of size n as stages of radix
+ * 4, 3, 5 and 2, in that order, so that the radix 4 stages get the longest
+ * runs of samples; returns 0 if n has other prime factors */
+static uint_t
+aubio_simd_fft_factor (aubio_simd_fft_t * s, uint_t n)
+{
+  const uint_t radices[3] = { 4, 3, 5 };
+  uint_t r;
+  s->n_stages = 0;
+  for (r = 0; r < 3; r++) {
+    while (n % radices[r] == 0) {
+      s->radix[s->n_stages++] = radices[r];
+      n /= radices[r];
+    }
+  }
+  if (n == 2) {
+    s->radix[s->n_stages++] = 2;
+    n = 1;
+  }
+  return n == 1;
+}
+
+/* fill the tables of the transform of size n as a circular convolution of
+ * size conv n, with
+ *
+ *   Z[k] = c[k] sum_j (x[j] c[j]) conj c[k - j], c[j] = exp (-i PI j^2 / n) */
+static void
+aubio_simd_fft_fill_bluestein (aubio_simd_fft_t * s)
+{
+  const uint_t n = s->n, conv_n = s->conv->n;
+  uint_t j;
+  smpl_t *br, *bi, *kr, *ki;
+  for (j = 0; j < n; j++) {
+    // j^2 modulo 2 n, to keep the angle accurate for large j
+    double theta = PI * (double)(((unsigned long long)j * j) % (2 * n)) / n;
+    s->chirp_re[j] = cos (theta);
+    s->chirp_im[j] = - sin (theta);
+  }
+  // the conjugate chirp, wrapped around for the negative lags
+  br = s->conv->work;
+  bi = br + conv_n;
+  for (j = 0; j < conv_n; j++) {
+    br[j] = 0.;
+    bi[j] = 0.;
+  }
+  for (j = 0; j < n; j++) {
+    br[j] = s->chirp_re[j];
+    bi[j] = - s->chirp_im[j];
+    if (j > 0) {
+      br[conv_n - j] = br[j];
+      bi[conv_n - j] = bi[j];
+    }
+  }
+  // its spectrum, scaled for the backward transform of the product
+  aubio_simd_fft_cfft (s->conv, &kr, &ki);
+  for (j = 0; j < conv_n; j++) {
+    s->kernel_re[j] = kr[j] / conv_n;
+    s->kernel_im[j] = ki[j] / conv_n;
+  }
+}
+
+/* the tables are cached in one block, laid out as tw, split_re, split_im,
+ * then with bluestein chirp_re, chirp_im, kernel_re, kernel_im */
+static uint_t
+aubio_simd_fft_tables_length (const aubio_simd_fft_t * s)
+{
+  uint_t length = s->n_tw + 2 * (s->n / 2 + 1);
+  if (s->conv) {
+    length += 2 * s->n + 2 * s->conv->n;
+  }
+  return length;
+}
+
+static void
+aubio_simd_fft_set_tables (aubio_simd_fft_t * s, smpl_t * tables)
+{
+  const uint_t n_chirp = s->conv ? s->n : 0;
+  s->tw = tables;
+  s->split_re = s->tw + s->n_tw;
+  s->split_im = s->split_re + s->n / 2 + 1;
+  s->chirp_re = s->split_im + s->n / 2 + 1;
+  s->chirp_im = s->chirp_re + n_chirp;
+  s->kernel_re = s->chirp_im + n_chirp;
+  s->kernel_im = s->kernel_re + (s->conv ? s->conv->n : 0);
+}
+
+/* fill the tables of the plan of s, given as arg */
+static uint_t
+aubio_simd_fft_fill (void * tables, uint_t size, uint_t samplerate UNUSED,
+    const void * arg)
+{
+  aubio_simd_fft_t *s = (aubio_simd_fft_t *) arg;
+  uint_t cur, m, p, k, r;
+  smpl_t *tw;
+  aubio_simd_fft_set_tables (s, (smpl_t *) tables);
+  tw = s->tw;
+  for (cur = s->n, r = 0; r < s->n_stages; cur /= s->radix[r], r++) {
+    m = cur / s->radix[r];
+    for (k = 1; k < s->radix[r]; k++) {
+      for (p = 0; p < m; p++) {
+        double theta = 2. * PI * k * p / cur;
+        tw[2 * (k - 1) * m + p] = cos (theta);
+        tw[(2 * k - 1) * m + p] = - sin (theta);
+      }
+    }
+    tw += 2 * (s->radix[r] - 1) * m;
+  }
+  for (k = 0; k <= s->n / 2; k++) {
+    double theta = 2. * PI * k / size;
+    s->split_re[k] = cos (theta);
+    s->split_im[k] = sin (theta);
+  }
+  if (s->conv) {
+    aubio_simd_fft_fill_bluestein (s);
+  }
+  return AUBIO_OK;
+}
+
+aubio_simd_fft_t *
+new_aubio_simd_fft (uint_t size)
+{
+  aubio_simd_fft_t *s = AUBIO_NEW (aubio_simd_fft_t);
+  uint_t cur, k, conv_n = 1;
+  if ((sint_t)size < 2 || size % 2 != 0) {
+    AUBIO_ERR ("fft: can only create with even sizes >= 2, requested %d,"
+        " try recompiling aubio with --enable-fftw3\n", size);
+    goto beach;
+  }
+  s->size = size;
+  s->n = size / 2;
+  s->kernels = &aubio_simd_fft_scalar;
+#if HAVE_SIMD_FFT_X86
+  __builtin_cpu_init ();
+  if (__builtin_cpu_supports ("avx2") && __builtin_cpu_supports ("fma")) {
+    s->kernels = &aubio_simd_fft_avx2;
+  } else if (__builtin_cpu_supports ("sse2")) {
+    s->kernels = &aubio_simd_fft_sse2;
+  }
+#endif /* HAVE_SIMD_FFT_X86 */
+  if (!aubio_simd_fft_factor (s, s->n)) {
+    // a circular convolution of a power of two size >= 2 n - 1
+    s->n_stages = 0;
+    while (conv_n < 2 * s->n - 1) conv_n *= 2;
+    s->conv = new_aubio_simd_fft (2 * conv_n);
+    if (!s->conv) goto beach;
+  }
+  for (cur = s->n, k = 0; k < s->n_stages; cur /= s->radix[k], k++) {
+    s->n_tw += 2 * (s->radix[k] - 1) * (cur / s->radix[k]);
+  }
+  s->tables = aubio_cache_acquire ("simd_fft", size, 0,
+      aubio_simd_fft_tables_length (s) * sizeof (smpl_t),
+      aubio_simd_fft_fill, s);
+  if (!s->tables) goto beach;
+  aubio_simd_fft_set_tables (s, (smpl_t *) s->tables);
+  s->work = AUBIO_ARRAY (smpl_t, 4 * s->n);
+  return s;
+
+beach:
+  if (s->conv) del_aubio_simd_fft (s->conv);
+  AUBIO_FREE (s);
+  return NULL;
+}
+
+void
+del_aubio_simd_fft (aubio_simd_fft_t * s)
+{
+  if (s->conv) del_aubio_simd_fft (s->conv);
+  aubio_cache_release (s->tables);
+  AUBIO_FREE (s->work);
+  AUBIO_FREE (s);
+}
+
+/* forward complex transform with bluestein's algorithm, from the first half
+ * of the work area to the second one */
+static void
+aubio_simd_fft_cfft_bluestein (aubio_simd_fft_t * s, smpl_t ** re,
+    smpl_t ** im)
+{
+  const uint_t n = s->n, conv_n = s->conv->n;
+  const smpl_t *xr = s->work, *xi = xr + n;
+  const smpl_t *cr = s->chirp_re, *ci = s->chirp_im;
+  smpl_t *yr = s->work + 2 * n, *yi = yr + n;
+  smpl_t *ar = s->conv->work, *ai = ar + conv_n, *zr, *zi, tr, ti;
+  uint_t j;
+  for (j = 0; j < n; j++) {
+    ar[j] = xr[j] * cr[j] - xi[j] * ci[j];
+    ai[j] = xr[j] * ci[j] + xi[j] * cr[j];
+  }
+  for (; j < conv_n; j++) {
+    ar[j] = 0.;
+    ai[j] = 0.;
+  }
+  aubio_simd_fft_cfft (s->conv, &zr, &zi);
+  // multiply by the spectrum of the conjugate chirp, and conjugate so that
+  // the forward transform gives the backward one
+  for (j = 0; j < conv_n; j++) {
+    tr = zr[j] * s->kernel_re[j] - zi[j] * s->kernel_im[j];
+    ti = zr[j] * s->kernel_im[j] + zi[j] * s->kernel_re[j];
+    ar[j] = tr;
+    ai[j] = - ti;
+  }
+  aubio_simd_fft_cfft (s->conv, &zr, &zi);
+  for (j = 0; j < n; j++) {
+    yr[j] = zr[j] * cr[j] + zi[j] * ci[j];
+    yi[j] = zr[j] * ci[j] - zi[j] * cr[j];
+  }
+  *re = yr;
+  *im = yi;
+}
+
+/* forward complex transform of the first half of the work area, the result
+ * is left in either half, pointed to by re and im */
+static void
+aubio_simd_fft_cfft (aubio_simd_fft_t * s, smpl_t ** re, smpl_t ** im)
+{
+  const aubio_simd_fft_kernels_t *kernels = s->kernels;
+  smpl_t *xr = s->work, *xi = xr + s->n, *yr = xi + s->n, *yi = yr + s->n;
+  smpl_t *tmp;
+  const smpl_t *tw = s->tw;
+  uint_t cur = s->n, stride = 1, k, radix;
+  if (s->conv) {
+    aubio_simd_fft_cfft_bluestein (s, re, im);
+    return;
+  }
+  for (k = 0; k < s->n_stages; k++) {
+    radix = s->radix[k];
+    if (radix == 4) {
+      kernels->radix4 (cur, stride, tw, xr, xi, yr, yi);
+    } else if (radix == 3) {
+      kernels->radix3 (cur, stride, tw, xr, xi, yr, yi);
+    } else if (radix == 5) {
+      kernels->radix5 (cur, stride, tw, xr, xi, yr, yi);
+    } else {
+      // radix 2, always last, with cur = 2
+      kernels->radix2 (stride, xr, xi, yr, yi);
+    }
+    tw += 2 * (radix - 1) * (cur / radix);
+    cur /= radix;
+    stride *= radix;
+    tmp = xr; xr = yr; yr = tmp;
+    tmp = xi; xi = yi; yi = tmp;
+  }
+  *re = xr;
+  *im = xi;
+}
+
+void
+aubio_simd_fft_rdft (aubio_simd_fft_t * s, int isgn, smpl_t * a)
+{
+  const aubio_simd_fft_kernels_t *kernels = s->kernels;
+  const uint_t n = s->n;
+  smpl_t *xr = s->work, *xi = xr + n, *zr, *zi;
+  if (isgn >= 0) {
+    // transform the even and odd samples as a complex sequence, then split
+    // its spectrum into the one of the real sequence
+    kernels->pack (n, a, xr, xi);
+    aubio_simd_fft_cfft (s, &zr, &zi);
+    kernels->split (n, s->split_re, s->split_im, zr, zi, a);
+  } else {
+    // the conjugate of the forward transform of the conjugate is the
+    // backward transform, scaled by n
+    kernels->merge (n, s->split_re, s->split_im, a, xr, xi);
+    aubio_simd_fft_cfft (s, &zr, &zi);
+    kernels->unpack (n, zr, zi, a);
+  }
+}
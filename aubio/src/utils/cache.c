@@ -0,0 +1,144 @@
+/*
+  Copyright (C) 2026 the audio-to-cv-pitch-lv2 contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "aubio_priv.h"
+#include "fvec.h"
+#include "musicutils.h"
+#include "utils/cache.h"
+#include <pthread.h>
+
+typedef struct _aubio_cache_entry_t aubio_cache_entry_t;
+
+/* a process has a few dozen tables at most, kept in a list */
+struct _aubio_cache_entry_t
+{
+  char_t *kind;               /**< kind of the table */
+  uint_t size;                /**< size the table is computed for */
+  uint_t samplerate;          /**< samplerate the table is computed for */
+  uint_t bytes;               /**< size of the table in bytes */
+  uint_t refs;                /**< number of objects using the table */
+  void *table;                /**< contents of the table */
+  aubio_cache_entry_t *next;  /**< next entry of the list */
+};
+
+static pthread_mutex_t aubio_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+static aubio_cache_entry_t *aubio_cache_entries = NULL;
+
+const void *
+aubio_cache_acquire (const char_t * kind, uint_t size, uint_t samplerate,
+    uint_t bytes, aubio_cache_fill_t fill, const void * arg)
+{
+  aubio_cache_entry_t *e;
+  const void *table = NULL;
+  pthread_mutex_lock (&aubio_cache_mutex);
+  for (e = aubio_cache_entries; e; e = e->next) {
+    if (e->size == size && e->samplerate == samplerate && e->bytes == bytes
+        && strcmp (e->kind, kind) == 0) {
+      e->refs++;
+      table = e->table;
+      goto unlock;
+    }
+  }
+  e = AUBIO_NEW (aubio_cache_entry_t);
+  e->kind = AUBIO_ARRAY (char_t, strlen (kind) + 1);
+  strcpy (e->kind, kind);
+  e->size = size;
+  e->samplerate = samplerate;
+  e->bytes = bytes;
+  e->refs = 1;
+  e->table = AUBIO_ARRAY (char, MAX (bytes, 1));
+  if (fill (e->table, size, samplerate, arg) != AUBIO_OK) {
+    AUBIO_FREE (e->table);
+    AUBIO_FREE (e->kind);
+    AUBIO_FREE (e);
+    goto unlock;
+  }
+  e->next = aubio_cache_entries;
+  aubio_cache_entries = e;
+  table = e->table;
+unlock:
+  pthread_mutex_unlock (&aubio_cache_mutex);
+  return table;
+}
+
+void
+aubio_cache_release (const void * table)
+{
+  aubio_cache_entry_t **prev, *e;
+  if (!table) return;
+  pthread_mutex_lock (&aubio_cache_mutex);
+  for (prev = &aubio_cache_entries; (e = *prev); prev = &e->next) {
+    if (e->table == table) {
+      if (--e->refs == 0) {
+        *prev = e->next;
+        AUBIO_FREE (e->table);
+        AUBIO_FREE (e->kind);
+        AUBIO_FREE (e);
+      }
+      break;
+    }
+  }
+  pthread_mutex_unlock (&aubio_cache_mutex);
+}
+
+fvec_t *
+aubio_cache_acquire_fvec (const char_t * kind, uint_t size,
+    uint_t samplerate, uint_t length, aubio_cache_fill_t fill,
+    const void * arg)
+{
+  const void *table = aubio_cache_acquire (kind, size, samplerate,
+      length * sizeof (smpl_t), fill, arg);
+  fvec_t *v;
+  if (!table) return NULL;
+  // the vector only points to the table, which is not freed with it
+  v = AUBIO_NEW (fvec_t);
+  v->length = length;
+  v->data = (smpl_t *) table;
+  return v;
+}
+
+void
+aubio_cache_release_fvec (fvec_t * v)
+{
+  aubio_cache_release (v->data);
+  AUBIO_FREE (v);
+}
+
+static uint_t
+aubio_cache_fill_window (void * table, uint_t size, uint_t samplerate UNUSED,
+    const void * arg)
+{
+  fvec_t win;
+  win.length = size;
+  win.data = (smpl_t *) table;
+  return fvec_set_window (&win, (char_t *) arg) == 0 ? AUBIO_OK : AUBIO_FAIL;
+}
+
+fvec_t *
+aubio_cache_acquire_window (char_t * window_type, uint_t size)
+{
+  if (window_type == NULL) {
+    AUBIO_ERR ("window type can not be null.\n");
+    return NULL;
+  }
+  // windows are cached under their type
+  return aubio_cache_acquire_fvec (window_type, size, 0, size,
+      aubio_cache_fill_window, window_type);
+}
@@ -0,0 +1,117 @@
+/*
+  Copyright (C) 2026 the audio-to-cv-pitch-lv2 contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/** \file
+
+  Process wide cache of read-only tables
+
+  Tables that objects compute when they are created and never write again,
+  such as fft twiddles, windows and weighting curves, are shared by all the
+  objects of the process that use the same ones. A table is identified by
+  its kind, size and samplerate, filled by the first object acquiring it,
+  and freed when the last one releases it.
+
+  Acquiring and releasing lock a mutex, and are meant to be called when
+  objects are created and deleted, not while they process audio.
+
+*/
+
+#ifndef AUBIO_CACHE_H
+#define AUBIO_CACHE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** fill a new table
+
+  \param table zeroed memory of the number of bytes given when acquiring it
+  \param size size of the table, as given when acquiring it
+  \param samplerate samplerate of the table, as given when acquiring it
+  \param arg argument given when acquiring the table
+
+  \return ::AUBIO_OK, or ::AUBIO_FAIL if the table could not be computed
+
+  The contents of the table must only depend on its kind, size and
+  samplerate. The cache mutex is held while filling.
+
+*/
+typedef uint_t (*aubio_cache_fill_t) (void * table, uint_t size,
+    uint_t samplerate, const void * arg);
+
+/** get a shared table, filled on first use
+
+  \param kind name of the kind of table, copied
+  \param size size the table is computed for
+  \param samplerate samplerate the table is computed for, or 0
+  \param bytes size of the table in bytes
+  \param fill function filling the table when it is not in the cache yet
+  \param arg argument passed to `fill`
+
+  \return the table, to be released with aubio_cache_release(), or NULL if
+  `fill` failed
+
+*/
+const void * aubio_cache_acquire (const char_t * kind, uint_t size,
+    uint_t samplerate, uint_t bytes, aubio_cache_fill_t fill,
+    const void * arg);
+
+/** release a table acquired with aubio_cache_acquire()
+
+  \param table table to release, freed when no other object uses it
+
+*/
+void aubio_cache_release (const void * table);
+
+/** get a shared table of `length` samples, as a vector
+
+  \return a vector pointing to the shared table, that must not be written
+  to, and is released with aubio_cache_release_fvec(), or NULL
+
+  See aubio_cache_acquire() for the other parameters.
+
+*/
+fvec_t * aubio_cache_acquire_fvec (const char_t * kind, uint_t size,
+    uint_t samplerate, uint_t length, aubio_cache_fill_t fill,
+    const void * arg);
+
+/** release a vector acquired with aubio_cache_acquire_fvec()
+
+  \param v vector to release
+
+*/
+void aubio_cache_release_fvec (fvec_t * v);
+
+/** get a shared window, see new_aubio_window()
+
+  \param window_type type of the window
+  \param size length of the window
+
+  \return a vector that must not be written to, released with
+  aubio_cache_release_fvec(), or NULL if the type is unknown
+
+*/
+fvec_t * aubio_cache_acquire_window (char_t * window_type, uint_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AUBIO_CACHE_H */
@@ -0,0 +1,82 @@
+//
+//  notetracker.cpp
+//
+
+#include "notetracker.hpp"
+
+NoteTracker::NoteTracker(uint32_t windowSize, uint32_t hopSize, uint32_t sampleRate)
+    : detector(new_aubio_notes("default", windowSize, hopSize, sampleRate)),
+      hop(new_fvec(hopSize)),
+      result(new_fvec(3)),
+      hopSize(hopSize),
+      fill(0)
+{
+    // so that the first hop in the audio thread does not map the buffers of
+    // the detector
+    fvec_zeros(hop);
+    if (detector != nullptr)
+        aubio_notes_prime(detector);
+}
+
+NoteTracker::~NoteTracker()
+{
+    if (detector != nullptr)
+        del_aubio_notes(detector);
+    del_fvec(hop);
+    del_fvec(result);
+}
+
+bool NoteTracker::isValid() const
+{
+    return detector != nullptr;
+}
+
+uint32_t NoteTracker::getLatency() const
+{
+    if (detector == nullptr)
+        return 0;
+
+    return aubio_notes_get_delay(detector);
+}
+
+uint32_t NoteTracker::getFramesUntilHop() const
+{
+    return hopSize - fill;
+}
+
+bool NoteTracker::write(const float* input, uint32_t frames, float gain)
+{
+    float* const data = hop->data + fill;
+
+    for (uint32_t f = 0; f < frames; f++) {
+        data[f] = input[f] * gain;
+    }
+
+    fill += frames;
+
+    if (fill < hopSize)
+        return false;
+
+    fill = 0;
+
+    if (detector == nullptr)
+        return false;
+
+    aubio_notes_do(detector, hop, result);
+    return true;
+}
+
+float NoteTracker::getNoteOn() const
+{
+    return result->data[0];
+}
+
+float NoteTracker::getVelocity() const
+{
+    return result->data[1];
+}
+
+bool NoteTracker::getNoteOff() const
+{
+    return result->data[2] != 0.0f;
+}
@@ -0,0 +1,50 @@
+//
+//  notetracker.hpp
+//
+//  Wraps the aubio note detector behind a hop-sized FIFO, so the analysis
+//  does not depend on the block size of the host and the caller knows the
+//  frame at which each hop, and so each note event, is complete.
+//
+
+#ifndef NoteTracker_h
+#define NoteTracker_h
+
+#include <stdint.h>
+#include "aubio.h"
+
+class NoteTracker {
+public:
+    NoteTracker(uint32_t windowSize, uint32_t hopSize, uint32_t sampleRate);
+    ~NoteTracker();
+
+    bool isValid() const;
+
+    // delay in frames between the start of a note and the end of the hop
+    // that reports it
+    uint32_t getLatency() const;
+
+    // frames to write before the next hop is complete
+    uint32_t getFramesUntilHop() const;
+
+    // append frames to the FIFO, without crossing a hop boundary, and run
+    // the detector when the hop is complete, returning whether it ran
+    bool write(const float* input, uint32_t frames, float gain);
+
+    // events of the last hop, as a MIDI note number and velocity, 0 when the
+    // hop started no note
+    float getNoteOn() const;
+    float getVelocity() const;
+
+    // whether the last hop ended the sounding note
+    bool getNoteOff() const;
+
+private:
+    aubio_notes_t* detector;
+    fvec_t* hop;
+    fvec_t* result;
+
+    uint32_t hopSize;
+    uint32_t fill;
+};
+
+#endif
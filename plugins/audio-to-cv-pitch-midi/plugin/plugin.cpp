@@ -0,0 +1,203 @@
+#include <cstdlib>
+#include "plugin.hpp"
+
+START_NAMESPACE_DISTRHO
+
+
+// -----------------------------------------------------------------------
+
+AudioToMIDIPitch::AudioToMIDIPitch()
+    : Plugin(paramCount, 0, 0)
+{
+    // FFT plans measured offline, used when aubio is built with FFTW3F, see
+    // audio-to-cv-pitch/utils/wisdom.cpp
+    aubio_fft_load_wisdom(std::getenv("AUDIO_TO_CV_PITCH_WISDOM"));
+
+    noteTracker = new NoteTracker(kWindowSize, kHopSize, getSampleRate());
+    setLatency(noteTracker->getLatency());
+    activeNote = -1;
+    activeChannel = 0;
+    releasePending = false;
+
+    sensitivity = 1.0;
+    octave = 0;
+    channel = 0;
+}
+
+AudioToMIDIPitch::~AudioToMIDIPitch()
+{
+    delete noteTracker;
+}
+
+// -----------------------------------------------------------------------
+// Init
+
+void AudioToMIDIPitch::initParameter(uint32_t index, Parameter& parameter)
+{
+    switch (index)
+    {
+        case paramSensitivity:
+            parameter.hints = kParameterIsAutomable;
+            parameter.name = "Sensitivity";
+            parameter.symbol = "Sensitivity";
+            parameter.ranges.def = 1.f;
+            parameter.ranges.min = 0.1f;
+            parameter.ranges.max = 3.f;
+            break;
+        case paramOctave:
+            parameter.hints = kParameterIsAutomable | kParameterIsInteger;
+            parameter.name = "Octave";
+            parameter.symbol = "Octave";
+            parameter.ranges.def = 0;
+            parameter.ranges.min = -3;
+            parameter.ranges.max = 3;
+            break;
+        case paramChannel:
+            parameter.hints = kParameterIsAutomable | kParameterIsInteger;
+            parameter.name = "Channel";
+            parameter.symbol = "Channel";
+            parameter.ranges.def = 1;
+            parameter.ranges.min = 1;
+            parameter.ranges.max = 16;
+            break;
+    }
+}
+
+// -----------------------------------------------------------------------
+// Internal data
+
+float AudioToMIDIPitch::getParameterValue(uint32_t index) const
+{
+    switch (index)
+    {
+        case paramSensitivity:
+            return sensitivity;
+        case paramOctave:
+            return octave;
+        case paramChannel:
+            return channel + 1;
+    }
+
+    return 0.0f;
+}
+
+void AudioToMIDIPitch::setParameterValue(uint32_t index, float value)
+{
+    switch (index)
+    {
+        case paramSensitivity:
+            sensitivity = value;
+            break;
+        case paramOctave:
+            octave = static_cast<int>(value);
+            break;
+        case paramChannel:
+            channel = static_cast<int>(value) - 1;
+            channel = (channel < 0) ? 0 : (channel > 15) ? 15 : channel;
+            break;
+    }
+}
+
+// -----------------------------------------------------------------------
+// Process
+
+void AudioToMIDIPitch::activate()
+{
+    // events can only be written from run(), where the note on sent before
+    // the host deactivated us is released
+    releasePending = true;
+}
+
+void AudioToMIDIPitch::deactivate()
+{
+}
+
+void AudioToMIDIPitch::sampleRateChanged(double newSampleRate)
+{
+    delete noteTracker;
+    noteTracker = new NoteTracker(kWindowSize, kHopSize, newSampleRate);
+    setLatency(noteTracker->getLatency());
+    releasePending = true;
+}
+
+void AudioToMIDIPitch::run(const float** inputs, float**, uint32_t numFrames)
+{
+    if (releasePending) {
+        midiNoteOff(0);
+        releasePending = false;
+    }
+
+    // feed the FIFO in chunks that never cross a hop boundary, so that the
+    // events of each hop are sent at the frame that completes it rather
+    // than at the start of the block
+    for (uint32_t offset = 0; offset < numFrames;) {
+        uint32_t frames = numFrames - offset;
+        if (frames > noteTracker->getFramesUntilHop())
+            frames = noteTracker->getFramesUntilHop();
+
+        if (noteTracker->write(inputs[0] + offset, frames, sensitivity)) {
+            const uint32_t frame = offset + frames - 1;
+            const float note = noteTracker->getNoteOn();
+
+            if (noteTracker->getNoteOff() || note > 0.0f)
+                midiNoteOff(frame);
+
+            if (note > 0.0f) {
+                int pitch = static_cast<int>(note + 0.5f) + 12 * octave;
+                pitch = (pitch < 0) ? 0 : (pitch > 127) ? 127 : pitch;
+
+                // aubio gives 127 plus the level in dB
+                float velocity = noteTracker->getVelocity();
+                velocity = (velocity < 1.0f) ? 1.0f : (velocity > 127.0f) ? 127.0f : velocity;
+
+                midiNoteOn(frame, pitch, velocity);
+            }
+        }
+
+        offset += frames;
+    }
+}
+
+void AudioToMIDIPitch::midiNoteOn(uint32_t frame, uint8_t pitch, uint8_t velocity)
+{
+    MidiEvent event;
+    event.frame = frame;
+    event.size = 3;
+    event.data[0] = 0x90 | channel;
+    event.data[1] = pitch;
+    event.data[2] = velocity;
+    event.dataExt = nullptr;
+
+    if (writeMidiEvent(event)) {
+        activeNote = pitch;
+        activeChannel = channel;
+    }
+}
+
+void AudioToMIDIPitch::midiNoteOff(uint32_t frame)
+{
+    if (activeNote < 0)
+        return;
+
+    MidiEvent event;
+    event.frame = frame;
+    event.size = 3;
+    event.data[0] = 0x80 | activeChannel;
+    event.data[1] = activeNote;
+    event.data[2] = 0;
+    event.dataExt = nullptr;
+
+    writeMidiEvent(event);
+    activeNote = -1;
+}
+
+// -----------------------------------------------------------------------
+
+Plugin* createPlugin()
+{
+    return new AudioToMIDIPitch();
+}
+
+// -----------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
@@ -0,0 +1,110 @@
+#ifndef DISTRHO_PLUGIN_SLPLUGIN_HPP_INCLUDED
+#define DISTRHO_PLUGIN_SLPLUGIN_HPP_INCLUDED
+
+#include "DistrhoPlugin.hpp"
+#include "notetracker.hpp"
+
+
+START_NAMESPACE_DISTRHO
+
+class AudioToMIDIPitch : public Plugin
+{
+public:
+    enum Parameters
+    {
+        paramSensitivity = 0,
+        paramOctave,
+        paramChannel,
+        paramCount
+    };
+
+    AudioToMIDIPitch();
+    ~AudioToMIDIPitch();
+
+protected:
+    // -------------------------------------------------------------------
+    // Information
+
+    const char* getLabel() const noexcept override
+    {
+        return "AudioToMIDIPitch";
+    }
+
+    const char* getDescription() const override
+    {
+        return "Audio to MIDI notes";
+    }
+
+    const char* getMaker() const noexcept override
+    {
+        return "BGSN";
+    }
+
+    const char* getHomePage() const override
+    {
+        return "http://bramgiesen.com";
+    }
+
+    const char* getLicense() const noexcept override
+    {
+        return "GPLv3.0";
+    }
+
+    uint32_t getVersion() const noexcept override
+    {
+        return d_version(1, 0, 8);
+    }
+
+    int64_t getUniqueId() const noexcept override
+    {
+        return d_cconst('C', 'S', 'D', 'n');
+    }
+
+    // -------------------------------------------------------------------
+    // Init
+
+    void initParameter(uint32_t index, Parameter& parameter) override;
+
+    // -------------------------------------------------------------------
+    // Internal data
+
+    float getParameterValue(uint32_t index) const override;
+    void  setParameterValue(uint32_t index, float value) override;
+
+    // -------------------------------------------------------------------
+    // Process
+    void activate() override;
+    void deactivate() override;
+    void sampleRateChanged(double newSampleRate) override;
+    void run(const float** inputs, float** outputs, uint32_t frames) override;
+
+private:
+    void midiNoteOn(uint32_t frame, uint8_t pitch, uint8_t velocity);
+    void midiNoteOff(uint32_t frame);
+
+    // the pitch detector of aubio_notes uses a window four times as long
+    static const uint32_t kWindowSize = 512;
+    static const uint32_t kHopSize    = 256;
+
+    NoteTracker *noteTracker;
+
+    // note and channel of the last note on, -1 when no note sounds
+    int activeNote;
+    int activeChannel;
+
+    // the active note is released at the start of the next run, after an
+    // activation or a new tracker
+    bool releasePending;
+
+    float sensitivity;
+    int   octave;
+    int   channel;
+
+    DISTRHO_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioToMIDIPitch)
+};
+
+// -----------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
+
+#endif  // DISTRHO_PLUGIN_SLPLUGIN_HPP_INCLUDED
@@ -0,0 +1,26 @@
+//
+//  DistrhoPluginInfo.h
+
+
+#ifndef DISTRHO_PLUGIN_INFO_H_INCLUDED
+#define DISTRHO_PLUGIN_INFO_H_INCLUDED
+
+#define DISTRHO_PLUGIN_BRAND "CSD"
+#define DISTRHO_PLUGIN_NAME  "Audio to CV Pitch Multi"
+#define DISTRHO_PLUGIN_URI   "http://bramgiesen.com/audio-to-cv-pitch-multi"
+
+#define DISTRHO_PLUGIN_HAS_UI        0
+#define DISTRHO_PLUGIN_IS_RT_SAFE    1
+
+#define DISTRHO_PLUGIN_NUM_INPUTS    8
+#define DISTRHO_PLUGIN_NUM_OUTPUTS   8
+#define DISTRHO_PLUGIN_WANT_MIDI_INPUT  0
+#define DISTRHO_PLUGIN_WANT_MIDI_OUTPUT 0
+
+#define DISTRHO_PLUGIN_WANT_LATENCY  1
+#define DISTRHO_PLUGIN_WANT_TIMEPOS  0
+#define DISTRHO_PLUGIN_WANT_PROGRAMS 0
+
+//#define DISTRHO_PLUGIN_LV2_CATEGORY "lv2:Plugin"
+
+#endif // DISTRHO_PLUGIN_INFO_H_INCLUDED
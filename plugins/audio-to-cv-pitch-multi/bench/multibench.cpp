@@ -0,0 +1,242 @@
+//
+//  multibench.cpp
+//
+//  Times the multichannel yinfast detector of the multi plugin against one
+//  aubio_pitch yinfast detector per channel, the detector each instance of
+//  the single channel plugin runs, on the same hop sized windows of
+//  harmonic signals at a different pitch on each channel, and checks that
+//  both find the same pitches. Silent channels, skipped by both, can be
+//  added with -q.
+//
+//  usage: audio-to-cv-pitch-multi-bench [-s 1024,2048] [-p 256] [-c 8] [-q 0] [-r 5]
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <getopt.h>
+
+#include "aubio.h"
+#include "pitch/pitchyinfastmulti.h"
+
+static const uint32_t kSampleRate = 48000;
+
+// hops timed in each pass
+static const uint32_t kHops = 2000;
+
+// same threshold as MultiPitchTracker, in dB
+static const float kSilence = -30.0f;
+
+// -----------------------------------------------------------------------
+
+// a note with a few harmonics and a little noise, from 55 Hz upwards by
+// fifths, or silence
+static std::vector<smpl_t> signal(uint32_t channel, uint32_t length, bool silent)
+{
+    std::vector<smpl_t> samples(length, 0.0f);
+    if (silent)
+        return samples;
+
+    const double freq = 55.0 * std::pow(1.5, channel % 6);
+    for (uint32_t i = 0; i < length; i++) {
+        const double phase = 2.0 * M_PI * freq * i / kSampleRate;
+        samples[i] = 0.5 * std::sin(phase) + 0.2 * std::sin(2.0 * phase + 1.0)
+                   + 0.1 * std::sin(3.0 * phase + 2.0)
+                   + 0.01 * ((smpl_t)std::rand() / RAND_MAX - 0.5f);
+    }
+    return samples;
+}
+
+// the windows of a pass, advancing by a hop each, end at the same samples for
+// both detectors. each pass returns its time per hop in microseconds, and the
+// pitch of each channel at each hop in Hz.
+static double singles(const std::vector<std::vector<smpl_t> >& input, uint32_t window, uint32_t hop,
+                      std::vector<float>& pitches)
+{
+    const uint32_t channels = input.size();
+    std::vector<aubio_pitch_t*> detectors;
+    fvec_t* out = new_fvec(1);
+    fvec_t in;
+    in.length = hop;
+
+    for (uint32_t c = 0; c < channels; c++) {
+        aubio_pitch_t* detector = new_aubio_pitch("yinfast", window, hop, kSampleRate);
+        aubio_pitch_set_unit(detector, "Hz");
+        aubio_pitch_set_silence(detector, kSilence);
+        aubio_pitch_prime(detector);
+        // fill the window up to the first timed hop
+        for (uint32_t h = 0; h + 1 < window / hop; h++) {
+            in.data = const_cast<smpl_t*>(input[c].data()) + h * hop;
+            aubio_pitch_do(detector, &in, out);
+        }
+        detectors.push_back(detector);
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32_t h = 0; h < kHops; h++) {
+        for (uint32_t c = 0; c < channels; c++) {
+            in.data = const_cast<smpl_t*>(input[c].data()) + window - hop + h * hop;
+            aubio_pitch_do(detectors[c], &in, out);
+            pitches[h * channels + c] = out->data[0];
+        }
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    for (aubio_pitch_t* detector : detectors)
+        del_aubio_pitch(detector);
+    del_fvec(out);
+
+    return std::chrono::duration<double, std::micro>(end - start).count() / kHops;
+}
+
+static double multi(const std::vector<std::vector<smpl_t> >& input, uint32_t window, uint32_t hop,
+                    std::vector<float>& pitches)
+{
+    const uint32_t channels = input.size();
+    std::vector<smpl_t*> rows(channels);
+    fmat_t in;
+    in.length = window;
+    in.height = channels;
+    in.data = rows.data();
+    fvec_t* out = new_fvec(channels);
+
+    aubio_pitchyinfast_multi_t* detector = new_aubio_pitchyinfast_multi(window, channels);
+    aubio_pitchyinfast_multi_set_hop_size(detector, hop);
+
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32_t h = 0; h < kHops; h++) {
+        for (uint32_t c = 0; c < channels; c++) {
+            rows[c] = const_cast<smpl_t*>(input[c].data()) + h * hop;
+            // as MultiPitchTracker does, from the level of the last hop
+            fvec_t last;
+            last.length = hop;
+            last.data = rows[c] + window - hop;
+            if (aubio_silence_detection(&last, kSilence) == 1)
+                aubio_pitchyinfast_multi_skip(detector, c);
+        }
+        aubio_pitchyinfast_multi_do(detector, &in, out);
+        for (uint32_t c = 0; c < channels; c++) {
+            pitches[h * channels + c] = out->data[c] > 0 ? kSampleRate / out->data[c] : 0.0f;
+        }
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    del_aubio_pitchyinfast_multi(detector);
+    del_fvec(out);
+
+    return std::chrono::duration<double, std::micro>(end - start).count() / kHops;
+}
+
+// -----------------------------------------------------------------------
+
+static std::vector<std::string> split(const char* list)
+{
+    std::vector<std::string> items;
+    std::string item;
+    for (const char* c = list; ; c++) {
+        if (*c == ',' || *c == '\0') {
+            if (!item.empty())
+                items.push_back(item);
+            item.clear();
+            if (*c == '\0')
+                break;
+        } else {
+            item += *c;
+        }
+    }
+    return items;
+}
+
+static void usage(const char* name)
+{
+    std::fprintf(stderr,
+        "usage: %s [-s sizes] [-p hop] [-c channels] [-q silent] [-r repeats]\n"
+        "  -s  comma separated window sizes, default 1024,2048,2560,4096\n"
+        "  -p  hop size, default 256\n"
+        "  -c  number of channels, default 8\n"
+        "  -q  number of silent channels among them, default 0\n"
+        "  -r  timed passes of each detector, default 5\n", name);
+}
+
+int main(int argc, char* argv[])
+{
+    std::vector<uint32_t> sizes = { 1024, 2048, 2560, 4096 };
+    uint32_t hop = 256;
+    uint32_t channels = 8;
+    uint32_t silent = 0;
+    uint32_t repeats = 5;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "s:p:c:q:r:")) != -1) {
+        switch (opt) {
+            case 's':
+                sizes.clear();
+                for (const std::string& size : split(optarg)) {
+                    const int value = std::atoi(size.c_str());
+                    if (value >= 8 && value % 2 == 0)
+                        sizes.push_back(value);
+                }
+                break;
+            case 'p':
+                hop = std::max(1, std::atoi(optarg));
+                break;
+            case 'c':
+                channels = std::max(1, std::atoi(optarg));
+                break;
+            case 'q':
+                silent = std::max(0, std::atoi(optarg));
+                break;
+            case 'r':
+                repeats = std::max(1, std::atoi(optarg));
+                break;
+            default:
+                usage(argv[0]);
+                return 1;
+        }
+    }
+
+    if (optind < argc || sizes.empty() || silent > channels) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    std::printf("%d channels, %d silent, hop %d\n", channels, silent, hop);
+    std::printf("%6s %14s %14s %8s %12s\n", "window", "singles us/hop", "multi us/hop", "speedup", "max diff Hz");
+
+    for (uint32_t window : sizes) {
+        if ((window / 2) % hop != 0) {
+            std::fprintf(stderr, "hop %d does not divide half the window %d\n", hop, window);
+            return 1;
+        }
+
+        std::vector<std::vector<smpl_t> > input;
+        for (uint32_t c = 0; c < channels; c++) {
+            input.push_back(signal(c, window + kHops * hop, c >= channels - silent));
+        }
+
+        // the passes of both detectors alternate, so that both see the same
+        // load of the machine, and the best one of each is kept
+        std::vector<float> singlePitches(kHops * channels), multiPitches(kHops * channels);
+        double singleTime = 0.0, multiTime = 0.0;
+        for (uint32_t r = 0; r < repeats; r++) {
+            const double singlePass = singles(input, window, hop, singlePitches);
+            const double multiPass = multi(input, window, hop, multiPitches);
+            singleTime = r == 0 ? singlePass : std::min(singleTime, singlePass);
+            multiTime = r == 0 ? multiPass : std::min(multiTime, multiPass);
+        }
+
+        double diff = 0.0;
+        for (size_t i = 0; i < singlePitches.size(); i++) {
+            diff = std::max(diff, (double)std::fabs(singlePitches[i] - multiPitches[i]));
+        }
+
+        std::printf("%6u %14.1f %14.1f %8.2f %12.3g\n", window, singleTime, multiTime,
+                    singleTime / multiTime, diff);
+    }
+
+    return 0;
+}
@@ -0,0 +1,160 @@
+//
+//  multipitchtracker.cpp
+//
+
+#include <string.h>
+#include "multipitchtracker.hpp"
+
+MultiPitchTracker::MultiPitchTracker(uint32_t channels, uint32_t windowSize, uint32_t hopSize, uint32_t sampleRate)
+    : detector(new_aubio_pitchyinfast_multi(windowSize, channels)),
+      ring(new_fmat(channels, 2 * windowSize)),
+      result(new_fvec(channels)),
+      pitch(new float[channels]),
+      channels(channels),
+      windowSize(windowSize),
+      hopSize(hopSize),
+      sampleRate(sampleRate),
+      ringPos(0),
+      fill(0),
+      silence(-30.0f)
+{
+    window.length = windowSize;
+    window.height = channels;
+    window.data = new float*[channels];
+
+    for (uint32_t c = 0; c < channels; c++) {
+        window.data[c] = ring->data[c];
+        pitch[c] = 0.0f;
+    }
+
+    // detect once on the silent window, so that the first hop in the audio
+    // thread does not map the buffers of the detector, nor transform every
+    // block of the window
+    fmat_zeros(ring);
+    if (detector != nullptr) {
+        aubio_pitchyinfast_multi_set_hop_size(detector, hopSize);
+        aubio_pitchyinfast_multi_do(detector, &window, result);
+    }
+}
+
+MultiPitchTracker::~MultiPitchTracker()
+{
+    if (detector != nullptr)
+        del_aubio_pitchyinfast_multi(detector);
+    del_fmat(ring);
+    delete[] window.data;
+    del_fvec(result);
+    delete[] pitch;
+}
+
+bool MultiPitchTracker::isValid() const
+{
+    return detector != nullptr;
+}
+
+uint32_t MultiPitchTracker::getChannels() const
+{
+    return channels;
+}
+
+uint32_t MultiPitchTracker::getWindowSize() const
+{
+    return windowSize;
+}
+
+uint32_t MultiPitchTracker::getHopSize() const
+{
+    return hopSize;
+}
+
+uint32_t MultiPitchTracker::getLatency() const
+{
+    if (detector == nullptr)
+        return 0;
+
+    return windowSize - (windowSize / 2 + windowSize / 4) / 2 + hopSize / 2;
+}
+
+uint32_t MultiPitchTracker::getFramesUntilHop() const
+{
+    return hopSize - fill;
+}
+
+bool MultiPitchTracker::write(const float** inputs, uint32_t frames, float gain)
+{
+    // the newest hop is written at the end of the window
+    const uint32_t start = windowSize - hopSize + fill;
+
+    for (uint32_t c = 0; c < channels; c++) {
+        float* const data = window.data[c] + start;
+
+        for (uint32_t f = 0; f < frames; f++) {
+            data[f] = inputs[c][f] * gain;
+        }
+    }
+
+    fill += frames;
+
+    if (fill < hopSize)
+        return false;
+
+    fill = 0;
+
+    if (detector == nullptr)
+        return false;
+
+    detect();
+
+    return true;
+}
+
+float MultiPitchTracker::getPitch(uint32_t channel) const
+{
+    return pitch[channel];
+}
+
+void MultiPitchTracker::setSilence(float newSilence)
+{
+    silence = newSilence;
+}
+
+void MultiPitchTracker::detect()
+{
+    for (uint32_t c = 0; c < channels; c++) {
+        // same as aubio_pitch_do, the silence gate looks at the last hop, and
+        // silent channels are not analysed
+        fvec_t lastHop;
+        lastHop.length = hopSize;
+        lastHop.data = window.data[c] + windowSize - hopSize;
+
+        if (aubio_silence_detection(&lastHop, silence) == 1)
+            aubio_pitchyinfast_multi_skip(detector, c);
+    }
+
+    aubio_pitchyinfast_multi_do(detector, &window, result);
+
+    for (uint32_t c = 0; c < channels; c++) {
+        const float period = result->data[c];
+
+        if (period > 0)
+            pitch[c] = sampleRate / period;
+        else
+            pitch[c] = 0.0f;
+    }
+
+    // make room for the next hop by sliding the windows forward in the ring,
+    // the overlap is copied back to its start when the end is reached, about
+    // once per window
+    if (ringPos + hopSize > windowSize) {
+        for (uint32_t c = 0; c < channels; c++) {
+            memcpy(ring->data[c], window.data[c] + hopSize, (windowSize - hopSize) * sizeof(float));
+        }
+        ringPos = 0;
+    } else {
+        ringPos += hopSize;
+    }
+
+    for (uint32_t c = 0; c < channels; c++) {
+        window.data[c] = ring->data[c] + ringPos;
+    }
+}
@@ -0,0 +1,65 @@
+//
+//  multipitchtracker.hpp
+//
+//  Runs the multichannel yinfast detector on a set of channels sharing the
+//  same window, hop size and hop-sized FIFO, so that the channels are
+//  analysed together instead of by one detector each. Each hop only the
+//  newest block of each channel is transformed, and silent channels are
+//  skipped.
+//
+
+#ifndef MultiPitchTracker_h
+#define MultiPitchTracker_h
+
+#include <stdint.h>
+#include "aubio.h"
+#include "pitch/pitchyinfastmulti.h"
+
+class MultiPitchTracker {
+public:
+    MultiPitchTracker(uint32_t channels, uint32_t windowSize, uint32_t hopSize, uint32_t sampleRate);
+    ~MultiPitchTracker();
+
+    bool isValid() const;
+    uint32_t getChannels() const;
+    uint32_t getWindowSize() const;
+    uint32_t getHopSize() const;
+
+    // delay in frames between the input and the CV describing it, the delay
+    // aubio_pitch_get_delay() gives for yinfast plus half a hop for holding
+    // each estimate until the next
+    uint32_t getLatency() const;
+
+    // number of frames that can be written before the next detection runs
+    uint32_t getFramesUntilHop() const;
+
+    // write at most getFramesUntilHop() frames of every channel, scaled by
+    // gain. returns true when the hop got complete and new estimates are
+    // available.
+    bool write(const float** inputs, uint32_t frames, float gain);
+
+    // last detected pitch of a channel in Hz, 0 when no pitch was found
+    float getPitch(uint32_t channel) const;
+
+    // silence threshold in dB, channels below it report no pitch
+    void setSilence(float silence);
+
+private:
+    void detect();
+
+    aubio_pitchyinfast_multi_t* detector;
+    fmat_t* ring;    // storage for the windows, twice their length
+    fmat_t window;   // window of each channel, a view in ring
+    fvec_t* result;
+    float* pitch;
+
+    uint32_t channels;
+    uint32_t windowSize;
+    uint32_t hopSize;
+    uint32_t sampleRate;
+    uint32_t ringPos;
+    uint32_t fill;
+    float silence;
+};
+
+#endif
@@ -0,0 +1,161 @@
+#include <cstdlib>
+#include "plugin.hpp"
+
+START_NAMESPACE_DISTRHO
+
+
+// -----------------------------------------------------------------------
+
+AudioToCVPitchMulti::AudioToCVPitchMulti()
+    : Plugin(paramCount, 0, 0)
+{
+    // FFT plans measured offline, used when aubio is built with FFTW3F, see
+    // audio-to-cv-pitch/utils/wisdom.cpp. The detector transforms all
+    // channels with one aubio_fft of the window size, planned when the
+    // tracker is built below.
+    aubio_fft_load_wisdom(std::getenv("AUDIO_TO_CV_PITCH_WISDOM"));
+
+    pitchTracker = new MultiPitchTracker(DISTRHO_PLUGIN_NUM_INPUTS, kWindowSize, kHopSize, getSampleRate());
+    setLatency(pitchTracker->getLatency());
+
+    sensitivity = 1.0;
+    octave = 0;
+}
+
+AudioToCVPitchMulti::~AudioToCVPitchMulti()
+{
+    delete pitchTracker;
+}
+
+// -----------------------------------------------------------------------
+// Init
+
+void AudioToCVPitchMulti::initParameter(uint32_t index, Parameter& parameter)
+{
+    switch (index)
+    {
+        case paramSensitivity:
+            parameter.hints = kParameterIsAutomable;
+            parameter.name = "Sensitivity";
+            parameter.symbol = "Sensitivity";
+            parameter.ranges.def = 1.f;
+            parameter.ranges.min = 0.1f;
+            parameter.ranges.max = 3.f;
+            break;
+        case paramOctave:
+            parameter.hints = kParameterIsAutomable | kParameterIsInteger;
+            parameter.name = "Octave";
+            parameter.symbol = "Octave";
+            parameter.ranges.def = 0;
+            parameter.ranges.min = -3;
+            parameter.ranges.max = 3;
+            break;
+    }
+}
+
+// -----------------------------------------------------------------------
+// Internal data
+
+float AudioToCVPitchMulti::getParameterValue(uint32_t index) const
+{
+    switch (index)
+    {
+        case paramSensitivity:
+            return sensitivity;
+        case paramOctave:
+            return octave;
+    }
+
+    return 0.0f;
+}
+
+void AudioToCVPitchMulti::setParameterValue(uint32_t index, float value)
+{
+    switch (index)
+    {
+        case paramSensitivity:
+            sensitivity = value;
+            break;
+        case paramOctave:
+            octave = static_cast<int>(value);
+            break;
+    }
+}
+
+// -----------------------------------------------------------------------
+// Process
+
+void AudioToCVPitchMulti::activate()
+{
+}
+
+void AudioToCVPitchMulti::deactivate()
+{
+}
+
+void AudioToCVPitchMulti::sampleRateChanged(double newSampleRate)
+{
+    delete pitchTracker;
+    pitchTracker = new MultiPitchTracker(DISTRHO_PLUGIN_NUM_INPUTS, kWindowSize, kHopSize, newSampleRate);
+    setLatency(pitchTracker->getLatency());
+}
+
+void AudioToCVPitchMulti::run(const float** inputs, float** outputs, uint32_t numFrames)
+{
+    float cvPitch[DISTRHO_PLUGIN_NUM_OUTPUTS];
+
+    for (uint32_t c = 0; c < DISTRHO_PLUGIN_NUM_OUTPUTS; c++) {
+        cvPitch[c] = pitchToCV(pitchTracker->getPitch(c));
+    }
+
+    // feed the FIFO in chunks that never cross a hop boundary, the detector
+    // runs on all channels each time a hop is complete and the outputs
+    // switch to the new estimates from the next sample on
+    for (uint32_t offset = 0; offset < numFrames;) {
+        uint32_t frames = numFrames - offset;
+        if (frames > pitchTracker->getFramesUntilHop())
+            frames = pitchTracker->getFramesUntilHop();
+
+        for (uint32_t c = 0; c < DISTRHO_PLUGIN_NUM_OUTPUTS; c++) {
+            for (uint32_t f = offset; f < offset + frames; f++) {
+                outputs[c][f] = cvPitch[c];
+            }
+        }
+
+        const float* chunk[DISTRHO_PLUGIN_NUM_INPUTS];
+        for (uint32_t c = 0; c < DISTRHO_PLUGIN_NUM_INPUTS; c++) {
+            chunk[c] = inputs[c] + offset;
+        }
+
+        if (pitchTracker->write(chunk, frames, sensitivity)) {
+            for (uint32_t c = 0; c < DISTRHO_PLUGIN_NUM_OUTPUTS; c++) {
+                cvPitch[c] = pitchToCV(pitchTracker->getPitch(c));
+            }
+        }
+
+        offset += frames;
+    }
+}
+
+float AudioToCVPitchMulti::pitchToCV(float detectedPitchInHz) const
+{
+    float linearPitch = (detectedPitchInHz > 0.0) ? (12*log2(detectedPitchInHz / 440.0) + 69.0) + (12 * octave) : 0.0;
+    float cvPitch = ((float)linearPitch * (1/12.0f));
+
+    //clip pitch between output range of 0 to 10 volt
+    cvPitch = (cvPitch < 0.0) ? 0.0 : cvPitch;
+    cvPitch = (cvPitch > 10.0) ? 10.0 : cvPitch;
+
+    return cvPitch;
+}
+
+// -----------------------------------------------------------------------
+
+Plugin* createPlugin()
+{
+    return new AudioToCVPitchMulti();
+}
+
+// -----------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
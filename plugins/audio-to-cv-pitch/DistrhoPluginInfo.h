@@ -13,10 +13,11 @@
 #define DISTRHO_PLUGIN_IS_RT_SAFE    1
 
 #define DISTRHO_PLUGIN_NUM_INPUTS    1
-#define DISTRHO_PLUGIN_NUM_OUTPUTS   1
+#define DISTRHO_PLUGIN_NUM_OUTPUTS   2
 #define DISTRHO_PLUGIN_WANT_MIDI_INPUT  0
 #define DISTRHO_PLUGIN_WANT_MIDI_OUTPUT 0
 
+#define DISTRHO_PLUGIN_WANT_LATENCY  1
 #define DISTRHO_PLUGIN_WANT_TIMEPOS  0
 #define DISTRHO_PLUGIN_WANT_PROGRAMS 0
 
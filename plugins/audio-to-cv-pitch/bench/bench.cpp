@@ -0,0 +1,262 @@
+//
+//  bench.cpp
+//
+//  Headless host that runs the plugin on WAV files at a range of block sizes
+//  and reports the time spent in run() for each pitch method, as a baseline
+//  for performance work. The first run() after activation is reported
+//  against the 99th percentile of the timed ones, `make test` checks that
+//  the trackers do not allocate in it.
+//
+//  usage: audio-to-cv-pitch-bench [-b 64,256,1024] [-m yinfast,yin] [-r 3] file.wav...
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <getopt.h>
+
+#include "src/DistrhoPluginInternal.hpp"
+#include "trackerworker.hpp"
+#include "io/source_wavread.h"
+
+USE_NAMESPACE_DISTRHO
+
+struct Audio {
+    std::vector<float> samples;
+    uint32_t sampleRate;
+};
+
+struct Stats {
+    double nsPerSample;
+    double firstBlock;
+    double minBlock;
+    double meanBlock;
+    double p99Block;
+    double maxBlock;
+    double realTimeFactor;
+};
+
+// -----------------------------------------------------------------------
+
+static bool readWav(const char* path, Audio& audio)
+{
+    const uint_t readSize = 4096;
+
+    aubio_source_wavread_t* source = new_aubio_source_wavread(path, 0, readSize);
+    if (source == nullptr)
+        return false;
+
+    fvec_t* buffer = new_fvec(readSize);
+    uint_t read = 0;
+
+    audio.samples.clear();
+    audio.sampleRate = aubio_source_wavread_get_samplerate(source);
+
+    // channels are downmixed to mono by the source
+    do {
+        aubio_source_wavread_do(source, buffer, &read);
+        audio.samples.insert(audio.samples.end(), buffer->data, buffer->data + read);
+    } while (read == readSize);
+
+    del_fvec(buffer);
+    del_aubio_source_wavread(source);
+    return !audio.samples.empty();
+}
+
+static bool writeMidi(void*, const MidiEvent&)
+{
+    return true;
+}
+
+static int32_t findParameter(const PluginExporter& plugin, const char* symbol)
+{
+    for (uint32_t i = 0; i < plugin.getParameterCount(); i++) {
+        if (plugin.getParameterSymbol(i) == symbol)
+            return i;
+    }
+    return -1;
+}
+
+static void runAudio(PluginExporter& plugin, const Audio& audio, uint32_t blockSize,
+                     std::vector<double>* blockTimes, size_t maxBlocks = SIZE_MAX)
+{
+    std::vector<float> pitch(blockSize), gate(blockSize);
+    float* outputs[DISTRHO_PLUGIN_NUM_OUTPUTS] = { pitch.data(), gate.data() };
+
+    for (size_t offset = 0; offset < audio.samples.size() && maxBlocks > 0; offset += blockSize, maxBlocks--) {
+        const uint32_t frames = std::min<size_t>(blockSize, audio.samples.size() - offset);
+        const float* inputs[DISTRHO_PLUGIN_NUM_INPUTS] = { audio.samples.data() + offset };
+
+        const auto start = std::chrono::steady_clock::now();
+        plugin.run(inputs, outputs, frames);
+        const auto end = std::chrono::steady_clock::now();
+
+        if (blockTimes != nullptr)
+            blockTimes->push_back(std::chrono::duration<double, std::nano>(end - start).count());
+    }
+}
+
+static Stats benchmark(const Audio& audio, uint32_t method, uint32_t blockSize, uint32_t repeats)
+{
+    d_lastBufferSize = blockSize;
+    d_lastSampleRate = audio.sampleRate;
+
+    PluginExporter plugin(nullptr, writeMidi);
+
+    // the method is set before activating, as a host restoring a state does,
+    // so that activate() builds its tracker
+    const int32_t methodParameter = findParameter(plugin, "Method");
+    if (methodParameter >= 0)
+        plugin.setParameterValue(methodParameter, method);
+    plugin.activate();
+
+    // the first block, which must not cost more than the ones that follow
+    std::vector<double> firstBlock;
+    runAudio(plugin, audio, blockSize, &firstBlock, 1);
+
+    // one untimed pass to settle caches and the onset detector state
+    runAudio(plugin, audio, blockSize, nullptr);
+
+    std::vector<double> blockTimes;
+    blockTimes.reserve(repeats * (audio.samples.size() / blockSize + 1));
+    for (uint32_t r = 0; r < repeats; r++) {
+        runAudio(plugin, audio, blockSize, &blockTimes);
+    }
+
+    plugin.deactivate();
+
+    std::sort(blockTimes.begin(), blockTimes.end());
+
+    double total = 0.0;
+    for (size_t i = 0; i < blockTimes.size(); i++) {
+        total += blockTimes[i];
+    }
+
+    const double samples = (double)audio.samples.size() * repeats;
+    const size_t p99 = (blockTimes.size() * 99 + 99) / 100 - 1;
+
+    Stats stats;
+    stats.nsPerSample = total / samples;
+    stats.firstBlock = firstBlock.front();
+    stats.minBlock = blockTimes.front();
+    stats.meanBlock = total / blockTimes.size();
+    stats.p99Block = blockTimes[p99];
+    stats.maxBlock = blockTimes.back();
+    // time spent processing per second of audio, below 1 is faster than
+    // real time
+    stats.realTimeFactor = total * 1e-9 / (samples / audio.sampleRate);
+    return stats;
+}
+
+// -----------------------------------------------------------------------
+
+static std::vector<std::string> split(const char* list)
+{
+    std::vector<std::string> items;
+    std::string item;
+    for (const char* c = list; ; c++) {
+        if (*c == ',' || *c == '\0') {
+            if (!item.empty())
+                items.push_back(item);
+            item.clear();
+            if (*c == '\0')
+                break;
+        } else {
+            item += *c;
+        }
+    }
+    return items;
+}
+
+static void usage(const char* name)
+{
+    std::fprintf(stderr,
+        "usage: %s [-b block sizes] [-m methods] [-r repeats] file.wav...\n"
+        "  -b  comma separated block sizes, default 64,256,1024\n"
+        "  -m  comma separated pitch methods, default all\n"
+        "  -r  timed passes over each file, default 3\n", name);
+}
+
+int main(int argc, char* argv[])
+{
+    std::vector<uint32_t> blockSizes = { 64, 256, 1024 };
+    std::vector<uint32_t> methods;
+    uint32_t repeats = 3;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "b:m:r:")) != -1) {
+        switch (opt) {
+            case 'b':
+                blockSizes.clear();
+                for (const std::string& size : split(optarg)) {
+                    if (std::atoi(size.c_str()) > 0)
+                        blockSizes.push_back(std::atoi(size.c_str()));
+                }
+                break;
+            case 'm':
+                for (const std::string& name : split(optarg)) {
+                    uint32_t method = 0;
+                    while (method < TrackerWorker::kNumMethods && name != TrackerWorker::getMethodName(method))
+                        method++;
+                    if (method == TrackerWorker::kNumMethods) {
+                        std::fprintf(stderr, "unknown pitch method '%s'\n", name.c_str());
+                        return 1;
+                    }
+                    methods.push_back(method);
+                }
+                break;
+            case 'r':
+                repeats = std::max(1, std::atoi(optarg));
+                break;
+            default:
+                usage(argv[0]);
+                return 1;
+        }
+    }
+
+    if (optind >= argc || blockSizes.empty()) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    if (methods.empty()) {
+        for (uint32_t method = 0; method < TrackerWorker::kNumMethods; method++) {
+            methods.push_back(method);
+        }
+    }
+
+    for (int i = optind; i < argc; i++) {
+        Audio audio;
+        if (!readWav(argv[i], audio)) {
+            std::fprintf(stderr, "could not read '%s'\n", argv[i]);
+            return 1;
+        }
+
+        std::printf("%s: %u Hz, %.2f s\n", argv[i], audio.sampleRate,
+                    (double)audio.samples.size() / audio.sampleRate);
+        std::printf("%-8s %6s %10s %10s %10s %10s %10s %10s %8s %10s\n", "method", "block",
+                    "ns/sample", "first us", "min us", "mean us", "p99 us", "max us", "RTF",
+                    "first/p99");
+
+        for (uint32_t method : methods) {
+            for (uint32_t blockSize : blockSizes) {
+                const Stats stats = benchmark(audio, method, blockSize, repeats);
+                const double firstRatio = stats.firstBlock / stats.p99Block;
+                std::printf("%-8s %6u %10.1f %10.2f %10.2f %10.2f %10.2f %10.2f %8.4f %10.2f\n",
+                            TrackerWorker::getMethodName(method), blockSize,
+                            stats.nsPerSample, stats.firstBlock * 1e-3, stats.minBlock * 1e-3,
+                            stats.meanBlock * 1e-3, stats.p99Block * 1e-3, stats.maxBlock * 1e-3,
+                            stats.realTimeFactor, firstRatio);
+            }
+        }
+
+        std::printf("\n");
+    }
+
+    return 0;
+}
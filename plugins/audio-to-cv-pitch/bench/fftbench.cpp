@@ -0,0 +1,226 @@
+//
+//  fftbench.cpp
+//
+//  Times the real FFT of aubio's vectorised backend against ooura's, which
+//  it replaces, on forward and backward transforms of random input at a
+//  range of sizes, and checks that both give the same spectrum. Ooura only
+//  does powers of two: at the other sizes the spectrum is checked against a
+//  direct transform instead, and the time against the next power of two.
+//
+//  usage: audio-to-cv-pitch-fftbench [-s 256,512,1440] [-r 3]
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <getopt.h>
+
+#include "aubio.h"
+
+// the backends are internal to aubio, and declared here the way
+// spectral/fft.c declares them
+extern "C" {
+typedef struct _aubio_simd_fft_t aubio_simd_fft_t;
+aubio_simd_fft_t* new_aubio_simd_fft(uint_t size);
+void del_aubio_simd_fft(aubio_simd_fft_t* s);
+void aubio_simd_fft_rdft(aubio_simd_fft_t* s, int isgn, smpl_t* a);
+void aubio_ooura_rdft(int n, int isgn, smpl_t* a, int* ip, smpl_t* w);
+}
+
+// enough transforms per timed pass to last a few milliseconds at any size
+static const uint32_t kSamplesPerPass = 1 << 22;
+
+struct Ooura {
+    explicit Ooura(uint32_t size)
+        : size(size), ip(size / 2 + 1, 0), w(size / 2 + 1) {}
+
+    void rdft(int isgn, smpl_t* a) { aubio_ooura_rdft(size, isgn, a, ip.data(), w.data()); }
+
+    uint32_t size;
+    std::vector<int> ip;
+    std::vector<smpl_t> w;
+};
+
+struct Simd {
+    explicit Simd(uint32_t size) : fft(new_aubio_simd_fft(size)) {}
+    ~Simd() { del_aubio_simd_fft(fft); }
+
+    void rdft(int isgn, smpl_t* a) { aubio_simd_fft_rdft(fft, isgn, a); }
+
+    aubio_simd_fft_t* fft;
+};
+
+// -----------------------------------------------------------------------
+
+// best time of a forward and a backward transform, in nanoseconds
+template <class Backend>
+static double benchmark(Backend& backend, const std::vector<smpl_t>& input, uint32_t repeats)
+{
+    std::vector<smpl_t> data(input);
+    const uint32_t transforms = std::max<uint32_t>(1, kSamplesPerPass / input.size());
+    // the backward transform is scaled by size / 2, undone as
+    // aubio_fft_rdo_packed does so that the data stays in range
+    const smpl_t scale = 2.0f / input.size();
+    double best = 0.0;
+
+    // one untimed pass to settle caches and the twiddle tables
+    for (uint32_t r = 0; r <= repeats; r++) {
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32_t t = 0; t < transforms; t++) {
+            backend.rdft(1, data.data());
+            backend.rdft(-1, data.data());
+            for (size_t i = 0; i < data.size(); i++) {
+                data[i] *= scale;
+            }
+        }
+        const auto end = std::chrono::steady_clock::now();
+        const double time = std::chrono::duration<double, std::nano>(end - start).count() / transforms;
+        if (r == 1 || (r > 1 && time < best))
+            best = time;
+    }
+    return best;
+}
+
+// packed spectrum of a direct transform in double precision
+static std::vector<smpl_t> dft(const std::vector<smpl_t>& input)
+{
+    const size_t size = input.size();
+    std::vector<double> c(size), s(size);
+    for (size_t i = 0; i < size; i++) {
+        c[i] = std::cos(2.0 * M_PI * i / size);
+        s[i] = std::sin(2.0 * M_PI * i / size);
+    }
+
+    std::vector<smpl_t> spectrum(size);
+    for (size_t k = 0; k <= size / 2; k++) {
+        double re = 0.0, im = 0.0;
+        for (size_t i = 0, j = 0; i < size; i++, j = (j + k) % size) {
+            re += input[i] * c[j];
+            im -= input[i] * s[j];
+        }
+        if (k == 0) {
+            spectrum[0] = re;
+        } else if (k == size / 2) {
+            spectrum[1] = re;
+        } else {
+            spectrum[2 * k] = re;
+            spectrum[2 * k + 1] = -im;
+        }
+    }
+    return spectrum;
+}
+
+// largest difference between the spectrum of the vectorised backend and
+// the reference one, relative to the largest bin
+static double compare(const std::vector<smpl_t>& reference, Simd& simd, const std::vector<smpl_t>& input)
+{
+    std::vector<smpl_t> b(input);
+    simd.rdft(1, b.data());
+
+    double error = 0.0, peak = 0.0;
+    for (size_t i = 0; i < reference.size(); i++) {
+        error = std::max(error, (double)std::fabs(reference[i] - b[i]));
+        peak = std::max(peak, (double)std::fabs(reference[i]));
+    }
+    return peak > 0.0 ? error / peak : error;
+}
+
+// -----------------------------------------------------------------------
+
+static std::vector<std::string> split(const char* list)
+{
+    std::vector<std::string> items;
+    std::string item;
+    for (const char* c = list; ; c++) {
+        if (*c == ',' || *c == '\0') {
+            if (!item.empty())
+                items.push_back(item);
+            item.clear();
+            if (*c == '\0')
+                break;
+        } else {
+            item += *c;
+        }
+    }
+    return items;
+}
+
+static void usage(const char* name)
+{
+    std::fprintf(stderr,
+        "usage: %s [-s sizes] [-r repeats]\n"
+        "  -s  comma separated even transform sizes,\n"
+        "      default 256,512,1024,1440,2048,2880,4096,8192\n"
+        "  -r  timed passes at each size, default 3\n", name);
+}
+
+int main(int argc, char* argv[])
+{
+    std::vector<uint32_t> sizes = { 256, 512, 1024, 1440, 2048, 2880, 4096, 8192 };
+    uint32_t repeats = 3;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "s:r:")) != -1) {
+        switch (opt) {
+            case 's':
+                sizes.clear();
+                for (const std::string& size : split(optarg)) {
+                    const int value = std::atoi(size.c_str());
+                    if (value >= 2 && value % 2 == 0)
+                        sizes.push_back(value);
+                }
+                break;
+            case 'r':
+                repeats = std::max(1, std::atoi(optarg));
+                break;
+            default:
+                usage(argv[0]);
+                return 1;
+        }
+    }
+
+    if (optind < argc || sizes.empty()) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    std::printf("%6s %12s %12s %8s %10s\n", "size", "ooura ns", "simd ns", "speedup", "max error");
+
+    for (uint32_t size : sizes) {
+        std::vector<smpl_t> input(size);
+        for (uint32_t i = 0; i < size; i++) {
+            input[i] = (smpl_t)std::rand() / RAND_MAX - 0.5f;
+        }
+
+        uint32_t oouraSize = 2;
+        while (oouraSize < size)
+            oouraSize *= 2;
+
+        std::vector<smpl_t> oouraInput(oouraSize);
+        for (uint32_t i = 0; i < oouraSize; i++) {
+            oouraInput[i] = i < size ? input[i] : 0.0f;
+        }
+
+        Ooura ooura(oouraSize);
+        Simd simd(size);
+
+        std::vector<smpl_t> reference(input);
+        if (oouraSize == size)
+            ooura.rdft(1, reference.data());
+        else
+            reference = dft(input);
+
+        const double error = compare(reference, simd, input);
+        const double oouraTime = benchmark(ooura, oouraInput, repeats);
+        const double simdTime = benchmark(simd, input, repeats);
+
+        std::printf("%6u %12.0f %12.0f %8.2f %10.2g\n", size, oouraTime, simdTime,
+                    oouraTime / simdTime, error);
+    }
+
+    return 0;
+}
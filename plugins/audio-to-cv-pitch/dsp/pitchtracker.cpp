@@ -0,0 +1,178 @@
+//
+//  pitchtracker.cpp
+//
+
+#include "pitchtracker.hpp"
+
+// level in dB under which no pitch is reported and the gate closes
+static const float kSilence = -30.0f;
+
+PitchTracker::PitchTracker(const char* method, uint32_t windowSize, uint32_t hopSize, uint32_t sampleRate)
+    : detector(new_aubio_pitch(method, windowSize, hopSize, sampleRate)),
+      tail(nullptr),
+      result(new_fvec(1)),
+      onsetDetector(nullptr),
+      spectrum(new_cvec(windowSize)),
+      windowSize(windowSize),
+      hopSize(hopSize),
+      sampleRate(sampleRate),
+      fill(0),
+      hopsToReady(windowSize / hopSize),
+      pitch(0.0f),
+      minFreq(0.0f),
+      maxFreq(0.0f),
+      rangeInDetector(true),
+      onset(false),
+      silent(true)
+{
+    if (detector != nullptr) {
+        // the input is scaled straight into the window of the detector
+        tail = aubio_pitch_get_tail(detector);
+        aubio_pitch_set_unit(detector, "Hz");
+        aubio_pitch_set_silence(detector, kSilence);
+
+        // the onset detector reads the spectrum of the pitch detector when the
+        // method computes one (yinfast, yinfft, specacf, mcomb and fcomb),
+        // and only needs a phase vocoder otherwise
+        if (aubio_pitch_get_spectrum(detector, spectrum) == 0)
+            onsetDetector = new_aubio_onset_spectrum("hfc", windowSize, hopSize, sampleRate);
+        else
+            onsetDetector = new_aubio_onset("hfc", windowSize, hopSize, sampleRate);
+    }
+    if (onsetDetector != nullptr) {
+        aubio_onset_set_silence(onsetDetector, kSilence);
+    }
+
+    // run the detectors once on silence, so that the first hop in the audio
+    // thread does not map their buffers, then forget the onset frame count.
+    // the window of a primed detector is silent, tail included
+    if (detector != nullptr) {
+        aubio_pitch_prime(detector);
+        if (onsetDetector != nullptr) {
+            if (aubio_pitch_get_spectrum(detector, spectrum) == 0)
+                aubio_onset_do_spectrum(onsetDetector, tail, spectrum, result);
+            else
+                aubio_onset_do(onsetDetector, tail, result);
+            aubio_onset_reset(onsetDetector);
+        }
+    }
+}
+
+PitchTracker::~PitchTracker()
+{
+    if (detector != nullptr)
+        del_aubio_pitch(detector);
+    if (onsetDetector != nullptr)
+        del_aubio_onset(onsetDetector);
+    del_cvec(spectrum);
+    del_fvec(result);
+}
+
+bool PitchTracker::isValid() const
+{
+    return detector != nullptr;
+}
+
+uint32_t PitchTracker::getWindowSize() const
+{
+    return windowSize;
+}
+
+uint32_t PitchTracker::getHopSize() const
+{
+    return hopSize;
+}
+
+uint32_t PitchTracker::getSampleRate() const
+{
+    return sampleRate;
+}
+
+uint32_t PitchTracker::getLatency() const
+{
+    if (detector == nullptr)
+        return 0;
+
+    return aubio_pitch_get_delay(detector) + hopSize / 2;
+}
+
+bool PitchTracker::isReady() const
+{
+    return hopsToReady == 0;
+}
+
+uint32_t PitchTracker::getFramesUntilHop() const
+{
+    return hopSize - fill;
+}
+
+bool PitchTracker::write(const float* input, uint32_t frames, float gain)
+{
+    if (detector != nullptr) {
+        float* const data = tail->data + fill;
+
+        for (uint32_t f = 0; f < frames; f++) {
+            data[f] = input[f] * gain;
+        }
+    }
+
+    fill += frames;
+
+    if (fill < hopSize)
+        return false;
+
+    fill = 0;
+
+    if (detector == nullptr)
+        return false;
+
+    if (hopsToReady > 0)
+        hopsToReady--;
+
+    // the samples of the hop stay in place, the detection only moves the tail
+    const fvec_t hop = *tail;
+    aubio_pitch_do_tail(detector, result);
+    pitch = result->data[0];
+
+    if (!rangeInDetector && (pitch < minFreq || pitch > maxFreq))
+        pitch = 0.0f;
+    silent = aubio_pitch_get_silent(detector) == 1;
+
+    // the onset detector reads the spectrum of the pitch detector instead of
+    // running its own phase vocoder, when the method computes one
+    onset = false;
+    if (onsetDetector != nullptr) {
+        if (aubio_pitch_get_spectrum(detector, spectrum) == 0)
+            aubio_onset_do_spectrum(onsetDetector, &hop, spectrum, result);
+        else
+            aubio_onset_do(onsetDetector, &hop, result);
+        onset = result->data[0] > 0.0f;
+    }
+
+    return true;
+}
+
+float PitchTracker::getPitch() const
+{
+    return pitch;
+}
+
+void PitchTracker::setFrequencyRange(float newMinFreq, float newMaxFreq)
+{
+    if (detector == nullptr || newMinFreq <= 0.0f || newMaxFreq < newMinFreq)
+        return;
+
+    minFreq = newMinFreq;
+    maxFreq = newMaxFreq;
+    rangeInDetector = aubio_pitch_set_frequency_range(detector, minFreq, maxFreq) == 0;
+}
+
+bool PitchTracker::getOnset() const
+{
+    return onset;
+}
+
+bool PitchTracker::isSilent() const
+{
+    return silent;
+}
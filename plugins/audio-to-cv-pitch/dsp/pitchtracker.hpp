@@ -0,0 +1,74 @@
+//
+//  pitchtracker.hpp
+//
+//  Wraps an aubio pitch detector behind a hop-sized FIFO, so the analysis
+//  window and hop size do not depend on the block size of the host. The FIFO
+//  is the end of the detector's own window. Onsets are detected on the
+//  spectrum computed by the pitch detector.
+//
+
+#ifndef PitchTracker_h
+#define PitchTracker_h
+
+#include <stdint.h>
+#include "aubio.h"
+
+class PitchTracker {
+public:
+    PitchTracker(const char* method, uint32_t windowSize, uint32_t hopSize, uint32_t sampleRate);
+    ~PitchTracker();
+
+    bool isValid() const;
+    uint32_t getWindowSize() const;
+    uint32_t getHopSize() const;
+    uint32_t getSampleRate() const;
+
+    // delay in frames between the input and the CV describing it, the
+    // detector delay plus half a hop for holding each estimate until the next
+    uint32_t getLatency() const;
+
+    // whether the detector has analysed a full window of input
+    bool isReady() const;
+
+    // number of frames that can be written before the next detection runs
+    uint32_t getFramesUntilHop() const;
+
+    // write at most getFramesUntilHop() frames, scaled by gain.
+    // returns true when the hop got complete and a new estimate is available.
+    bool write(const float* input, uint32_t frames, float gain);
+
+    // last detected pitch in Hz, 0 when no pitch was found
+    float getPitch() const;
+
+    // restrict the detection to a range of frequencies, the lags out of the
+    // range are not computed by the YIN methods, the other methods report
+    // no pitch outside of it
+    void setFrequencyRange(float minFreq, float maxFreq);
+
+    // whether an onset was detected in the last hop
+    bool getOnset() const;
+
+    // whether the last hop was below the silence threshold
+    bool isSilent() const;
+
+private:
+    aubio_pitch_t* detector;
+    fvec_t* tail;
+    fvec_t* result;
+    aubio_onset_t* onsetDetector;
+    cvec_t* spectrum;
+
+    uint32_t windowSize;
+    uint32_t hopSize;
+    uint32_t sampleRate;
+    uint32_t fill;
+    uint32_t hopsToReady;
+    float pitch;
+    float minFreq;
+    float maxFreq;
+    bool rangeInDetector;
+    bool onset;
+    bool silent;
+};
+
+#endif
@@ -1,4 +1,8 @@
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
 #include "plugin.hpp"
+#include "windowsizes.hpp"
 
 START_NAMESPACE_DISTRHO
 
@@ -8,20 +12,43 @@ START_NAMESPACE_DISTRHO
 AudioToCVPitch::AudioToCVPitch()
     : Plugin(paramCount, 0, 0)
 {
-    aubio = &pitchDetector;
-    aubio->setBuffersize(getBufferSize());
-    aubio->setHopfactor(8);
-    aubio->setSamplerate(getSampleRate());
-    pitchDetector.setPitchMethod("yinfast");
-    pitchDetector.setSilenceThreshold(-30.0f);
-    pitchDetector.setPitchOutput("Hz");
+    // FFT plans measured offline, used when aubio is built with FFTW3F, see
+    // audio-to-cv-pitch/utils/wisdom.cpp. Trackers are built here, in
+    // activate() and on the worker thread, so planning never happens in
+    // run().
+    aubio_fft_load_wisdom(std::getenv("AUDIO_TO_CV_PITCH_WISDOM"));
+
+    // yinfast, 2048 samples window, 256 samples hop
+    window = 2;
+    hop = 2;
+    minFreq = 20.0f;
+    maxFreq = 5000.0f;
+    config.method = 0;
+    config.sampleRate = getSampleRate();
+    updateConfig();
+
+    pitchTracker = TrackerWorker::build(config);
+    nextTracker = nullptr;
+    worker = new TrackerWorker(config);
+    setLatency(pitchTracker->getLatency());
+
+    gate = false;
+    retriggerFrames = getSampleRate() * kRetriggerMs / 1000;
+    retriggerCountdown = 0;
 
     sensitivity = 1.0;
     octave = 0;
+
+    dspLoad = 0.0f;
+    dspPeak = 0.0f;
+    peakHoldCountdown = 0;
 }
 
 AudioToCVPitch::~AudioToCVPitch()
 {
+    delete worker;
+    delete pitchTracker;
+    delete nextTracker;
 }
 
 // -----------------------------------------------------------------------
@@ -47,6 +74,103 @@ void AudioToCVPitch::initParameter(uint32_t index, Parameter& parameter)
             parameter.ranges.min = -3;
             parameter.ranges.max = 3;
             break;
+        case paramMethod:
+        {
+            parameter.hints = kParameterIsAutomable | kParameterIsInteger;
+            parameter.name = "Method";
+            parameter.symbol = "Method";
+            parameter.ranges.def = 0;
+            parameter.ranges.min = 0;
+            parameter.ranges.max = TrackerWorker::kNumMethods - 1;
+            parameter.enumValues.count = TrackerWorker::kNumMethods;
+            parameter.enumValues.restrictedMode = true;
+            ParameterEnumerationValue* const values = new ParameterEnumerationValue[TrackerWorker::kNumMethods];
+            for (uint32_t i = 0; i < TrackerWorker::kNumMethods; i++) {
+                values[i].label = TrackerWorker::getMethodName(i);
+                values[i].value = i;
+            }
+            parameter.enumValues.values = values;
+            break;
+        }
+        case paramWindow:
+        {
+            parameter.hints = kParameterIsAutomable | kParameterIsInteger;
+            parameter.name = "Window";
+            parameter.symbol = "Window";
+            parameter.ranges.def = 2;
+            parameter.ranges.min = 0;
+            parameter.ranges.max = kNumWindows - 1;
+            parameter.enumValues.count = kNumWindows;
+            parameter.enumValues.restrictedMode = true;
+            ParameterEnumerationValue* const values = new ParameterEnumerationValue[kNumWindows];
+            values[0].label = "512";
+            values[1].label = "1024";
+            values[2].label = "2048";
+            values[3].label = "4096";
+            values[4].label = "Auto";
+            for (uint32_t i = 0; i < kNumWindows; i++) {
+                values[i].value = i;
+            }
+            parameter.enumValues.values = values;
+            break;
+        }
+        case paramHop:
+        {
+            parameter.hints = kParameterIsAutomable | kParameterIsInteger;
+            parameter.name = "Hop";
+            parameter.symbol = "Hop";
+            parameter.ranges.def = 2;
+            parameter.ranges.min = 0;
+            parameter.ranges.max = kNumHops - 1;
+            parameter.enumValues.count = kNumHops;
+            parameter.enumValues.restrictedMode = true;
+            ParameterEnumerationValue* const values = new ParameterEnumerationValue[kNumHops];
+            values[0].label = "1/2 window";
+            values[1].label = "1/4 window";
+            values[2].label = "1/8 window";
+            values[3].label = "1/16 window";
+            for (uint32_t i = 0; i < kNumHops; i++) {
+                values[i].value = i;
+            }
+            parameter.enumValues.values = values;
+            break;
+        }
+        case paramMinFreq:
+            parameter.hints = kParameterIsAutomable | kParameterIsLogarithmic;
+            parameter.name = "Min Frequency";
+            parameter.symbol = "MinFreq";
+            parameter.unit = "Hz";
+            parameter.ranges.def = 20.0f;
+            parameter.ranges.min = 20.0f;
+            parameter.ranges.max = 2000.0f;
+            break;
+        case paramMaxFreq:
+            parameter.hints = kParameterIsAutomable | kParameterIsLogarithmic;
+            parameter.name = "Max Frequency";
+            parameter.symbol = "MaxFreq";
+            parameter.unit = "Hz";
+            parameter.ranges.def = 5000.0f;
+            parameter.ranges.min = 50.0f;
+            parameter.ranges.max = 5000.0f;
+            break;
+        case paramDspLoad:
+            parameter.hints = kParameterIsOutput;
+            parameter.name = "DSP Load";
+            parameter.symbol = "DspLoad";
+            parameter.unit = "%";
+            parameter.ranges.def = 0.0f;
+            parameter.ranges.min = 0.0f;
+            parameter.ranges.max = 100.0f;
+            break;
+        case paramDspPeak:
+            parameter.hints = kParameterIsOutput;
+            parameter.name = "DSP Peak";
+            parameter.symbol = "DspPeak";
+            parameter.unit = "%";
+            parameter.ranges.def = 0.0f;
+            parameter.ranges.min = 0.0f;
+            parameter.ranges.max = 100.0f;
+            break;
     }
 }
 
@@ -61,6 +185,20 @@ float AudioToCVPitch::getParameterValue(uint32_t index) const
             return sensitivity;
         case paramOctave:
             return octave;
+        case paramMethod:
+            return config.method;
+        case paramWindow:
+            return window;
+        case paramHop:
+            return hop;
+        case paramMinFreq:
+            return minFreq;
+        case paramMaxFreq:
+            return maxFreq;
+        case paramDspLoad:
+            return dspLoad;
+        case paramDspPeak:
+            return dspPeak;
     }
 }
 
@@ -74,6 +212,33 @@ void AudioToCVPitch::setParameterValue(uint32_t index, float value)
         case paramOctave:
             octave = static_cast<int>(value);
             break;
+        case paramMethod:
+            config.method = static_cast<uint32_t>(value);
+            updateConfig();
+            worker->request(config);
+            break;
+        case paramWindow:
+            window = static_cast<uint32_t>(value);
+            updateConfig();
+            worker->request(config);
+            break;
+        case paramHop:
+            hop = static_cast<uint32_t>(value);
+            updateConfig();
+            worker->request(config);
+            break;
+        case paramMinFreq:
+            minFreq = value;
+            updateConfig();
+            updateFrequencyRange();
+            worker->request(config);
+            break;
+        case paramMaxFreq:
+            maxFreq = value;
+            updateConfig();
+            updateFrequencyRange();
+            worker->request(config);
+            break;
     }
 }
 
@@ -82,23 +247,194 @@ void AudioToCVPitch::setParameterValue(uint32_t index, float value)
 
 void AudioToCVPitch::activate()
 {
+    // the settings a host restores before activating get their tracker
+    // built and primed here, instead of running it alongside the default
+    // one during the first window of run()
+    worker->reset(config);
+    delete nextTracker;
+    nextTracker = nullptr;
+    delete pitchTracker;
+    pitchTracker = TrackerWorker::build(config);
+    setLatency(pitchTracker->getLatency());
+
+    dspLoad = 0.0f;
+    dspPeak = 0.0f;
+    peakHoldCountdown = 0;
 }
 
 void AudioToCVPitch::deactivate()
 {
 }
 
+void AudioToCVPitch::sampleRateChanged(double newSampleRate)
+{
+    // the tracker for the new rate is built and swapped in like on a
+    // parameter change, until then the pitch and range of the current ones
+    // are rescaled to the new rate
+    config.sampleRate = newSampleRate;
+    updateConfig();
+    updateFrequencyRange();
+    worker->request(config);
+
+    retriggerFrames = newSampleRate * kRetriggerMs / 1000;
+    retriggerCountdown = 0;
+}
+
 void AudioToCVPitch::run(const float** inputs, float** outputs, uint32_t numFrames)
 {
-    float inputBuffer[1024];
-    float *input;
-    input = inputBuffer;
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    // a tracker built for new settings first runs alongside the current one,
+    // replacing a previous one still warming up. It is left with the worker
+    // while the previous one cannot be retired.
+    if (nextTracker == nullptr || worker->canRetire()) {
+        PitchTracker* built = worker->fetch();
+        if (built != nullptr) {
+            if (nextTracker != nullptr)
+                worker->retire(nextTracker);
+            nextTracker = built;
+            // the range may have changed since the worker built it
+            setTrackerRange(nextTracker);
+        }
+    }
+
+    float cvPitch = pitchToCV(getTrackerPitch(pitchTracker));
+
+    // feed the FIFO in chunks that never cross a hop boundary, the detector
+    // runs each time a hop is complete and the output switches to the new
+    // estimate from the next sample on
+    for (uint32_t offset = 0; offset < numFrames;) {
+        uint32_t frames = numFrames - offset;
+        if (frames > pitchTracker->getFramesUntilHop())
+            frames = pitchTracker->getFramesUntilHop();
+        if (nextTracker != nullptr && frames > nextTracker->getFramesUntilHop())
+            frames = nextTracker->getFramesUntilHop();
+
+        for (uint32_t f = offset; f < offset + frames; f++) {
+            outputs[0][f] = cvPitch;
+        }
+
+        for (uint32_t f = offset; f < offset + frames; f++) {
+            if (retriggerCountdown > 0) {
+                retriggerCountdown--;
+                outputs[1][f] = 0.0f;
+            } else {
+                outputs[1][f] = gate ? kGateHigh : 0.0f;
+            }
+        }
+
+        if (pitchTracker->write(inputs[0] + offset, frames, sensitivity)) {
+            cvPitch = pitchToCV(getTrackerPitch(pitchTracker));
+            updateGate();
+        }
+
+        if (nextTracker != nullptr) {
+            nextTracker->write(inputs[0] + offset, frames, sensitivity);
+
+            // the current tracker stays in use until the worker has a free
+            // slot to take it back
+            if (nextTracker->isReady() && worker->retire(pitchTracker)) {
+                pitchTracker = nextTracker;
+                nextTracker = nullptr;
+                setLatency(pitchTracker->getLatency());
+                cvPitch = pitchToCV(getTrackerPitch(pitchTracker));
+            }
+        }
+
+        offset += frames;
+    }
+
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    updateDspLoad(elapsed.count(), numFrames);
+}
+
+void AudioToCVPitch::updateConfig()
+{
+    config.minFreq = (minFreq < maxFreq) ? minFreq : maxFreq;
+    config.maxFreq = (minFreq < maxFreq) ? maxFreq : minFreq;
 
-    for (unsigned f = 0; f < numFrames; f++) {
-        input[f] = inputs[0][f] * sensitivity;
+    if (window == kAutoWindow) {
+        // smallest window in which the method finds the longest period
+        // searched, not rounded up to a power of two
+        const float longestPeriod = config.sampleRate / config.minFreq;
+        config.windowSize = kMinWindowSize;
+        while (config.windowSize < kMaxWindowSize &&
+               TrackerWorker::getLongestPeriod(config.method, config.windowSize) < longestPeriod) {
+            do {
+                config.windowSize += 16;
+            } while (!isFastWindowSize(config.windowSize));
+        }
+    } else {
+        // 512 to 4096 samples
+        config.windowSize = 512 << (window < kAutoWindow ? window : 0);
     }
 
-    float detectedPitchInHz = aubio->process((float*)input);
+    // half to a sixteenth of the window
+    config.hopSize = config.windowSize >> (1 + (hop < kNumHops ? hop : 0));
+}
+
+void AudioToCVPitch::updateFrequencyRange()
+{
+    // only stores the range in the detectors, safe on the audio thread
+    setTrackerRange(pitchTracker);
+    if (nextTracker != nullptr)
+        setTrackerRange(nextTracker);
+}
+
+float AudioToCVPitch::getTrackerPitch(const PitchTracker* tracker) const
+{
+    // a tracker built before the sample rate changed counts its periods in
+    // frames at the new rate, but converts them with the old one
+    return tracker->getPitch() * ((float)config.sampleRate / tracker->getSampleRate());
+}
+
+void AudioToCVPitch::setTrackerRange(PitchTracker* tracker) const
+{
+    // the range as seen by a tracker built for another sample rate
+    const float scale = (float)tracker->getSampleRate() / config.sampleRate;
+    tracker->setFrequencyRange(config.minFreq * scale, config.maxFreq * scale);
+}
+
+void AudioToCVPitch::updateDspLoad(double seconds, uint32_t frames)
+{
+    if (frames == 0)
+        return;
+
+    const double sampleRate = getSampleRate();
+    const float load = 100.0 * seconds * sampleRate / frames;
+
+    // one pole smoothing with a coefficient scaled by the block length, so
+    // the time constant does not depend on the host block size
+    const float coeff = std::exp(-(float)frames / (kLoadSmoothingSeconds * sampleRate));
+    dspLoad = load + coeff * (dspLoad - load);
+
+    if (load >= dspPeak) {
+        dspPeak = load;
+        peakHoldCountdown = kPeakHoldSeconds * sampleRate;
+    } else if (peakHoldCountdown > frames) {
+        peakHoldCountdown -= frames;
+    } else {
+        peakHoldCountdown = 0;
+        dspPeak = dspLoad;
+    }
+}
+
+void AudioToCVPitch::updateGate()
+{
+    // the gate opens on an onset and closes on silence, an onset while it is
+    // open briefly closes it to retrigger envelopes
+    if (pitchTracker->isSilent()) {
+        gate = false;
+        retriggerCountdown = 0;
+    } else if (pitchTracker->getOnset()) {
+        if (gate)
+            retriggerCountdown = retriggerFrames;
+        gate = true;
+    }
+}
+
+float AudioToCVPitch::pitchToCV(float detectedPitchInHz) const
+{
     float linearPitch = (detectedPitchInHz > 0.0) ? (12*log2(detectedPitchInHz / 440.0) + 69.0) + (12 * octave) : 0.0;
     float cvPitch = ((float)linearPitch * (1/12.0f));
 
@@ -106,13 +442,9 @@ void AudioToCVPitch::run(const float** inputs, float** outputs, uint32_t numFram
     cvPitch = (cvPitch < 0.0) ? 0.0 : cvPitch;
     cvPitch = (cvPitch > 10.0) ? 10.0 : cvPitch;
 
-    for (unsigned f = 0; f < numFrames; f++) {
-        outputs[0][f] = cvPitch;
-    }
+    return cvPitch;
 }
 
-
-
 // -----------------------------------------------------------------------
 
 Plugin* createPlugin()
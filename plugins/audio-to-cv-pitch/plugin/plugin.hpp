@@ -2,7 +2,8 @@
 #define DISTRHO_PLUGIN_SLPLUGIN_HPP_INCLUDED
 
 #include "DistrhoPlugin.hpp"
-#include "aubio_pitch.hpp"
+#include "pitchtracker.hpp"
+#include "trackerworker.hpp"
 
 
 START_NAMESPACE_DISTRHO
@@ -14,6 +15,13 @@ public:
     {
         paramSensitivity = 0,
         paramOctave,
+        paramMethod,
+        paramWindow,
+        paramHop,
+        paramMinFreq,
+        paramMaxFreq,
+        paramDspLoad,
+        paramDspPeak,
         paramCount
     };
 
@@ -74,18 +82,58 @@ protected:
     // Process
     void activate() override;
     void deactivate() override;
+    void sampleRateChanged(double newSampleRate) override;
     void midiNoteOn(uint8_t pitch, uint8_t velocity);
     void midiNoteOff(uint8_t pitch);
     void run(const float** inputs, float** outputs, uint32_t frames) override;
 
 private:
-
-    AubioModule *aubio;
-    AubioPitch pitchDetector;
+    float pitchToCV(float detectedPitchInHz) const;
+    void updateGate();
+    void updateConfig();
+    void updateFrequencyRange();
+    float getTrackerPitch(const PitchTracker* tracker) const;
+    void setTrackerRange(PitchTracker* tracker) const;
+    void updateDspLoad(double seconds, uint32_t frames);
+
+    static const uint32_t kNumWindows = 5;
+    static const uint32_t kAutoWindow = 4;
+    static const uint32_t kNumHops    = 4;
+
+    // the gate drops for 2 ms when an onset is detected while it is open
+    static const uint32_t kRetriggerMs = 2;
+    static constexpr float kGateHigh   = 10.0f;
+
+    // the load is smoothed over about 300 ms, the peak held for 2 s
+    static constexpr float kLoadSmoothingSeconds = 0.3f;
+    static constexpr float kPeakHoldSeconds      = 2.0f;
+
+    // window and hop parameters, resolved to sizes in config
+    uint32_t window;
+    uint32_t hop;
+    float    minFreq;
+    float    maxFreq;
+
+    TrackerWorker::Config config;
+    TrackerWorker *worker;
+
+    // the tracker in use, and the one replacing it once it has analysed a
+    // full window, both fed with the same input meanwhile
+    PitchTracker *pitchTracker;
+    PitchTracker *nextTracker;
+
+    bool     gate;
+    uint32_t retriggerFrames;
+    uint32_t retriggerCountdown;
 
     float sensitivity;
     int   octave;
 
+    // percentage of the block period spent in run()
+    float dspLoad;
+    float dspPeak;
+    uint32_t peakHoldCountdown;
+
     DISTRHO_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioToCVPitch)
 };
 
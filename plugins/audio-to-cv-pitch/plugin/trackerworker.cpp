@@ -0,0 +1,188 @@
+//
+//  trackerworker.cpp
+//
+
+#include <cstring>
+#include "trackerworker.hpp"
+
+START_NAMESPACE_DISTRHO
+
+static const char* const kMethods[TrackerWorker::kNumMethods] = {
+    "yinfast", "yin", "yinfft", "specacf", "mcomb", "fcomb", "schmitt", "mpm",
+    "bitacf"
+};
+
+// -----------------------------------------------------------------------
+
+const char* TrackerWorker::getMethodName(uint32_t method)
+{
+    return kMethods[method < kNumMethods ? method : 0];
+}
+
+uint32_t TrackerWorker::getLongestPeriod(uint32_t method, uint32_t windowSize)
+{
+    // leave the few lags needed to find the extremum at the period
+    if (std::strcmp(getMethodName(method), "mpm") == 0)
+        return windowSize * 3 / 4 - 4;
+    return windowSize / 2 - 4;
+}
+
+PitchTracker* TrackerWorker::build(const Config& config)
+{
+    PitchTracker* tracker = new PitchTracker(getMethodName(config.method),
+                                             config.windowSize,
+                                             config.hopSize,
+                                             config.sampleRate);
+    tracker->setFrequencyRange(config.minFreq, config.maxFreq);
+    return tracker;
+}
+
+// -----------------------------------------------------------------------
+
+TrackerWorker::TrackerWorker(const Config& initial)
+    : Thread("pitch tracker worker"),
+      requested(pack(initial)),
+      requestedRange(packRange(initial)),
+      pending(nullptr),
+      built(pack(initial))
+{
+    for (uint32_t i = 0; i < kRetireSlots; i++) {
+        retired[i] = nullptr;
+    }
+
+    startThread();
+}
+
+TrackerWorker::~TrackerWorker()
+{
+    stop();
+
+    delete pending.exchange(nullptr);
+
+    for (uint32_t i = 0; i < kRetireSlots; i++) {
+        delete retired[i].exchange(nullptr);
+    }
+}
+
+void TrackerWorker::reset(const Config& current)
+{
+    // the thread is stopped so that it does not publish a tracker for an
+    // older request in between
+    stop();
+
+    delete pending.exchange(nullptr);
+
+    requestedRange = packRange(current);
+    requested = pack(current);
+    built = requested;
+
+    startThread();
+}
+
+void TrackerWorker::request(const Config& config)
+{
+    requestedRange = packRange(config);
+    requested = pack(config);
+    wakeUp.post();
+}
+
+PitchTracker* TrackerWorker::fetch()
+{
+    PitchTracker* const tracker = pending.exchange(nullptr);
+
+    // a request made while the tracker was waiting to be fetched can now be
+    // built
+    if (tracker != nullptr)
+        wakeUp.post();
+
+    return tracker;
+}
+
+bool TrackerWorker::canRetire() const
+{
+    for (uint32_t i = 0; i < kRetireSlots; i++) {
+        if (retired[i] == nullptr)
+            return true;
+    }
+
+    return false;
+}
+
+bool TrackerWorker::retire(PitchTracker* tracker)
+{
+    // the worker empties all slots each time it wakes up, they only fill up
+    // when it is late, and the trackers then wait in the audio thread
+    for (uint32_t i = 0; i < kRetireSlots; i++) {
+        PitchTracker* empty = nullptr;
+        if (retired[i].compare_exchange_strong(empty, tracker)) {
+            wakeUp.post();
+            return true;
+        }
+    }
+
+    wakeUp.post();
+    return false;
+}
+
+void TrackerWorker::run()
+{
+    while (!shouldThreadExit())
+    {
+        for (uint32_t i = 0; i < kRetireSlots; i++) {
+            delete retired[i].exchange(nullptr);
+        }
+
+        const uint64_t config = requested;
+
+        if (config != built && pending == nullptr) {
+            pending = build(unpack(config, requestedRange));
+            built = config;
+        }
+
+        wakeUp.wait();
+    }
+}
+
+void TrackerWorker::stop()
+{
+    signalThreadShouldExit();
+    wakeUp.post();
+    stopThread(-1);
+}
+
+// -----------------------------------------------------------------------
+
+uint64_t TrackerWorker::pack(const Config& config)
+{
+    return (uint64_t)(config.method & 0xff) << 56
+         | (uint64_t)(config.windowSize & 0xffff) << 40
+         | (uint64_t)(config.hopSize & 0xffff) << 24
+         | (config.sampleRate & 0xffffff);
+}
+
+uint64_t TrackerWorker::packRange(const Config& config)
+{
+    uint32_t minFreq, maxFreq;
+    std::memcpy(&minFreq, &config.minFreq, sizeof(float));
+    std::memcpy(&maxFreq, &config.maxFreq, sizeof(float));
+    return (uint64_t)minFreq << 32 | maxFreq;
+}
+
+TrackerWorker::Config TrackerWorker::unpack(uint64_t packed, uint64_t packedRange)
+{
+    Config config;
+    config.method = (packed >> 56) & 0xff;
+    config.windowSize = (packed >> 40) & 0xffff;
+    config.hopSize = (packed >> 24) & 0xffff;
+    config.sampleRate = packed & 0xffffff;
+
+    const uint32_t minFreq = packedRange >> 32;
+    const uint32_t maxFreq = packedRange & 0xffffffff;
+    std::memcpy(&config.minFreq, &minFreq, sizeof(float));
+    std::memcpy(&config.maxFreq, &maxFreq, sizeof(float));
+    return config;
+}
+
+// -----------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
@@ -0,0 +1,95 @@
+//
+//  trackerworker.hpp
+//
+//  Builds pitch trackers on a background thread, so that the method, window,
+//  hop size and sample rate can change without allocating in run(). The
+//  audio thread requests a configuration, fetches the tracker once it is
+//  built, and hands the tracker it replaces back to be deleted. The thread
+//  sleeps until one of these calls wakes it up.
+//
+
+#ifndef TrackerWorker_h
+#define TrackerWorker_h
+
+#include <atomic>
+#include "extra/Semaphore.hpp"
+#include "extra/Thread.hpp"
+#include "pitchtracker.hpp"
+
+START_NAMESPACE_DISTRHO
+
+class TrackerWorker : public Thread
+{
+public:
+    struct Config {
+        uint32_t method;     // index in the method list
+        uint32_t windowSize;
+        uint32_t hopSize;
+        uint32_t sampleRate;
+        float minFreq;
+        float maxFreq;
+    };
+
+    static const uint32_t kNumMethods = 9;
+
+    static const char* getMethodName(uint32_t method);
+
+    // longest period in frames that the method finds in a window, the YIN
+    // methods search lags up to half of it, mpm up to three quarters so that
+    // the overlap at the longest lag stays usable
+    static uint32_t getLongestPeriod(uint32_t method, uint32_t windowSize);
+
+    // builds a tracker right away, for use outside of the audio thread
+    static PitchTracker* build(const Config& config);
+
+    TrackerWorker(const Config& initial);
+    ~TrackerWorker() override;
+
+    // drop the tracker being built or not fetched yet, and consider the one
+    // of the given configuration built, for use outside of the audio thread
+    void reset(const Config& current);
+
+    // the functions below are safe to call from the audio thread
+
+    // ask for a tracker with the given configuration, a new one is only
+    // built when the method, sizes or sample rate change
+    void request(const Config& config);
+
+    // tracker built for the last request, or nullptr when there is none yet
+    PitchTracker* fetch();
+
+    // whether a tracker can be retired now, the slots are only emptied by
+    // the worker so one free now stays free until retire() is called
+    bool canRetire() const;
+
+    // give back a tracker that is not used anymore, it is deleted later on.
+    // returns false when all slots are taken, the caller then keeps the
+    // tracker and tries again later
+    bool retire(PitchTracker* tracker);
+
+protected:
+    void run() override;
+
+private:
+    static const uint32_t kRetireSlots = 4;
+
+    static uint64_t pack(const Config& config);
+    static uint64_t packRange(const Config& config);
+    static Config unpack(uint64_t packed, uint64_t packedRange);
+
+    // wake the thread up and wait until it exits
+    void stop();
+
+    std::atomic<uint64_t> requested;
+    std::atomic<uint64_t> requestedRange;
+    std::atomic<PitchTracker*> pending;
+    std::atomic<PitchTracker*> retired[kRetireSlots];
+    uint64_t built;
+    Semaphore wakeUp;
+
+    DISTRHO_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TrackerWorker)
+};
+
+END_NAMESPACE_DISTRHO
+
+#endif
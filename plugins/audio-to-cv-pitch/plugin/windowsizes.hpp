@@ -0,0 +1,35 @@
+//
+//  windowsizes.hpp
+//
+//  Analysis windows the plugin can use, shared with the wisdom generator so
+//  that it plans the FFT sizes of all of them.
+//
+
+#ifndef WindowSizes_h
+#define WindowSizes_h
+
+#include <stdint.h>
+
+// range of the Auto window, which includes the fixed 512 to 4096 samples ones
+static const uint32_t kMinWindowSize = 256;
+static const uint32_t kMaxWindowSize = 16384;
+
+// windows of the Auto setting: multiples of 16, which every hop divides,
+// whose FFT sizes have no prime factor other than 2, 3 and 5, the ones
+// aubio's built-in FFT transforms without falling back to Bluestein
+static inline bool isFastWindowSize(uint32_t windowSize)
+{
+    static const uint32_t kFactors[3] = { 2, 3, 5 };
+
+    if (windowSize % 16 != 0)
+        return false;
+
+    uint32_t rest = windowSize / 16;
+    for (uint32_t i = 0; i < 3; i++) {
+        while (rest % kFactors[i] == 0)
+            rest /= kFactors[i];
+    }
+    return rest == 1;
+}
+
+#endif
@@ -0,0 +1,266 @@
+//
+//  primetest.cpp
+//
+//  Checks that a PitchTracker, once built, does no setup work while it runs:
+//  aubio_pitch_prime must leave nothing for the first aubio_pitch_do to
+//  allocate or compute, nor for the hops after it. Each method is built at a
+//  range of window and hop sizes and fed a generated signal, silence first so
+//  that the detectors skip it, then a tone. The test fails when, after the
+//  constructor:
+//
+//  - aubio or the tracker calls malloc, calloc or realloc,
+//  - a table is acquired from aubio's cache, or an ooura transform still has
+//    to compute its twiddles, which it does without allocating,
+//  - the first hop analysed costs more than kFirstHopMargin times the median
+//    hop, the best of kTimedTrackers trackers fed the tone from the start.
+//
+//  The calls are counted by linking with GNU ld's --wrap, see the Makefile.
+//  No allocation counted in the constructor means the wrapping is missing.
+//
+//  usage: audio-to-cv-pitch-test
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "pitchtracker.hpp"
+#include "utils/cache.h"
+
+// -----------------------------------------------------------------------
+// calls counted while `counting` is set
+
+static bool counting = false;
+static uint32_t allocations = 0;
+static uint32_t setups = 0;
+
+extern "C" {
+
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+const void* __real_aubio_cache_acquire(const char_t* kind, uint_t size, uint_t samplerate,
+                                       uint_t bytes, aubio_cache_fill_t fill, const void* arg);
+fvec_t* __real_aubio_cache_acquire_fvec(const char_t* kind, uint_t size, uint_t samplerate,
+                                        uint_t length, aubio_cache_fill_t fill, const void* arg);
+fvec_t* __real_aubio_cache_acquire_window(char_t* window_type, uint_t size);
+void __real_aubio_ooura_rdft(int n, int isgn, smpl_t* a, int* ip, smpl_t* w);
+
+void* __wrap_malloc(size_t size)
+{
+    if (counting)
+        allocations++;
+    return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t count, size_t size)
+{
+    if (counting)
+        allocations++;
+    return __real_calloc(count, size);
+}
+
+void* __wrap_realloc(void* ptr, size_t size)
+{
+    if (counting)
+        allocations++;
+    return __real_realloc(ptr, size);
+}
+
+const void* __wrap_aubio_cache_acquire(const char_t* kind, uint_t size, uint_t samplerate,
+                                       uint_t bytes, aubio_cache_fill_t fill, const void* arg)
+{
+    if (counting)
+        setups++;
+    return __real_aubio_cache_acquire(kind, size, samplerate, bytes, fill, arg);
+}
+
+fvec_t* __wrap_aubio_cache_acquire_fvec(const char_t* kind, uint_t size, uint_t samplerate,
+                                        uint_t length, aubio_cache_fill_t fill, const void* arg)
+{
+    if (counting)
+        setups++;
+    return __real_aubio_cache_acquire_fvec(kind, size, samplerate, length, fill, arg);
+}
+
+fvec_t* __wrap_aubio_cache_acquire_window(char_t* window_type, uint_t size)
+{
+    if (counting)
+        setups++;
+    return __real_aubio_cache_acquire_window(window_type, size);
+}
+
+// rdft computes the twiddles of a size when the lengths in ip[0] and ip[1]
+// are too short for it, the first time it sees an ip zeroed by calloc
+void __wrap_aubio_ooura_rdft(int n, int isgn, smpl_t* a, int* ip, smpl_t* w)
+{
+    if (counting && (n > (ip[0] << 2) || n > (ip[1] << 2)))
+        setups++;
+    __real_aubio_ooura_rdft(n, isgn, a, ip, w);
+}
+
+}
+
+// -----------------------------------------------------------------------
+
+static const uint32_t kSampleRate = 48000;
+
+// same list as TrackerWorker, which depends on DPF
+static const char* const kMethods[] = {
+    "yinfast", "yin", "yinfft", "specacf", "mcomb", "fcomb", "schmitt", "mpm",
+    "bitacf"
+};
+
+// the fixed windows of the plugin and two of its automatic sizes
+static const uint32_t kWindowSizes[] = { 512, 1024, 2048, 2880, 4096, 4800 };
+
+// written in blocks of a size that is no divisor of the hops, like a host
+static const uint32_t kBlockSize = 100;
+
+// windows of silence, then of tone
+static const uint32_t kSilentWindows = 2;
+static const uint32_t kToneWindows = 3;
+
+// how much slower than the median hop the first one may be. The first
+// window of a tone is half silent at the longest hops, which makes yin
+// search more lags, up to 1.4 times the median. Without priming, yin and
+// yinfast compute the whole window at once, up to 5 times the median.
+static const double kFirstHopMargin = 2.0;
+
+// trackers timed for each size, the fastest first hop is kept
+static const uint32_t kTimedTrackers = 5;
+
+// a 220 Hz note with a few harmonics
+static std::vector<float> signal(uint32_t silent, uint32_t length)
+{
+    std::vector<float> samples(length, 0.0f);
+    for (uint32_t i = silent; i < length; i++) {
+        const double phase = 2.0 * M_PI * 220.0 * i / kSampleRate;
+        samples[i] = 0.5 * std::sin(phase) + 0.2 * std::sin(2.0 * phase + 1.0)
+                   + 0.1 * std::sin(3.0 * phase + 2.0);
+    }
+    return samples;
+}
+
+struct Run {
+    uint32_t built;        // allocations in the constructor
+    uint32_t allocations;  // after it
+    uint32_t setups;       // tables acquired or computed after it
+    double firstHop;       // microseconds of the write() completing the first hop
+    std::vector<double> hops;  // and of those after the first window
+};
+
+static Run run(const char* method, uint32_t windowSize, uint32_t hopSize,
+               const std::vector<float>& input)
+{
+    Run result;
+
+    allocations = 0;
+    setups = 0;
+    counting = true;
+
+    PitchTracker* tracker = new PitchTracker(method, windowSize, hopSize, kSampleRate);
+
+    result.built = allocations;
+    allocations = 0;
+    setups = 0;
+
+    // as the plugin does on the audio thread once it fetched the tracker
+    tracker->setFrequencyRange(50.0f, 2000.0f);
+
+    uint32_t hops = 0;
+    for (uint32_t offset = 0; offset < input.size();) {
+        uint32_t frames = input.size() - offset;
+        if (frames > kBlockSize)
+            frames = kBlockSize;
+        if (frames > tracker->getFramesUntilHop())
+            frames = tracker->getFramesUntilHop();
+
+        const auto start = std::chrono::steady_clock::now();
+        const bool hop = tracker->write(input.data() + offset, frames, 1.0f);
+        const auto end = std::chrono::steady_clock::now();
+
+        if (hop) {
+            const double us = std::chrono::duration<double, std::micro>(end - start).count();
+            if (hops == 0)
+                result.firstHop = us;
+            else if (hops > windowSize / hopSize)
+                result.hops.push_back(us);
+            hops++;
+        }
+        offset += frames;
+    }
+
+    counting = false;
+    result.allocations = allocations;
+    result.setups = setups;
+
+    delete tracker;
+    return result;
+}
+
+int main()
+{
+    uint32_t failures = 0, runs = 0;
+    double worstRatio = 0.0;
+
+    for (const char* method : kMethods) {
+        for (uint32_t windowSize : kWindowSizes) {
+            const uint32_t length = (kSilentWindows + kToneWindows) * windowSize;
+            const std::vector<float> silenceThenTone = signal(kSilentWindows * windowSize, length);
+            const std::vector<float> tone = signal(0, length);
+
+            // half to a sixteenth of the window
+            for (uint32_t shift = 1; shift <= 4; shift++) {
+                const uint32_t hopSize = windowSize >> shift;
+                bool failed = false;
+                runs++;
+
+                const Run counted = run(method, windowSize, hopSize, silenceThenTone);
+                if (counted.built == 0) {
+                    std::fprintf(stderr, "no allocation counted in the constructor, the test"
+                                 " must be linked with the --wrap options of the Makefile\n");
+                    return 1;
+                }
+                if (counted.allocations != 0) {
+                    std::fprintf(stderr, "%s, window %u, hop %u: %u allocations after priming\n",
+                                 method, windowSize, hopSize, counted.allocations);
+                    failed = true;
+                }
+                if (counted.setups != 0) {
+                    std::fprintf(stderr, "%s, window %u, hop %u: %u tables set up after priming\n",
+                                 method, windowSize, hopSize, counted.setups);
+                    failed = true;
+                }
+
+                double firstHop = 0.0;
+                std::vector<double> hops;
+                for (uint32_t t = 0; t < kTimedTrackers; t++) {
+                    const Run timed = run(method, windowSize, hopSize, tone);
+                    firstHop = t == 0 ? timed.firstHop : std::min(firstHop, timed.firstHop);
+                    hops.insert(hops.end(), timed.hops.begin(), timed.hops.end());
+                }
+                std::nth_element(hops.begin(), hops.begin() + hops.size() / 2, hops.end());
+                const double ratio = firstHop / hops[hops.size() / 2];
+                worstRatio = std::max(worstRatio, ratio);
+                if (ratio > kFirstHopMargin) {
+                    std::fprintf(stderr, "%s, window %u, hop %u: first hop %.2f times the median,"
+                                 " more than %.2f\n", method, windowSize, hopSize, ratio,
+                                 kFirstHopMargin);
+                    failed = true;
+                }
+
+                if (failed)
+                    failures++;
+            }
+        }
+    }
+
+    std::printf("%u of %u trackers did setup work after priming, first hop at most %.2f"
+                " times the median\n", failures, runs, worstRatio);
+    return failures != 0 ? 1 : 0;
+}
@@ -0,0 +1,104 @@
+//
+//  wisdom.cpp
+//
+//  Generates FFTW wisdom offline for aubio built with HAVE_FFTW3F=true. The
+//  plans of every FFT size the plugins may use are measured, which can take
+//  minutes, and saved so that the plugins load them at instantiation instead
+//  of estimating theirs. These are the sizes of every window the Auto setting
+//  can pick, which include the fixed ones and the 2048 samples window of the
+//  multi plugin, twice them for mpm and half of them for the yinfft
+//  difference function.
+//
+//  The plugins load FFTW's system wisdom, usually /etc/fftw/wisdomf, or the
+//  file named by AUDIO_TO_CV_PITCH_WISDOM when it is set.
+//
+//  usage: audio-to-cv-pitch-wisdom [-s 64,128,256] file
+//
+
+#include <cstdio>
+#include <cstdlib>
+#include <set>
+#include <string>
+#include <vector>
+#include <getopt.h>
+
+#include "aubio.h"
+#include "windowsizes.hpp"
+
+// -----------------------------------------------------------------------
+
+static std::vector<std::string> split(const char* list)
+{
+    std::vector<std::string> items;
+    std::string item;
+    for (const char* c = list; ; c++) {
+        if (*c == ',' || *c == '\0') {
+            if (!item.empty())
+                items.push_back(item);
+            item.clear();
+            if (*c == '\0')
+                break;
+        } else {
+            item += *c;
+        }
+    }
+    return items;
+}
+
+static void usage(const char* name)
+{
+    std::fprintf(stderr,
+        "usage: %s [-s sizes] file\n"
+        "  -s  comma separated FFT sizes, default those of the plugin windows\n"
+        "  file  wisdom to write, merged with the system wisdom\n", name);
+}
+
+int main(int argc, char* argv[])
+{
+    std::set<uint_t> windowSizes;
+    for (uint32_t window = kMinWindowSize; window <= kMaxWindowSize; window += 16) {
+        if (isFastWindowSize(window)) {
+            windowSizes.insert(window / 2);
+            windowSizes.insert(window);
+            windowSizes.insert(window * 2);
+        }
+    }
+    std::vector<uint_t> sizes(windowSizes.begin(), windowSizes.end());
+
+    int opt;
+    while ((opt = getopt(argc, argv, "s:")) != -1) {
+        switch (opt) {
+            case 's':
+                sizes.clear();
+                for (const std::string& size : split(optarg)) {
+                    if (std::atoi(size.c_str()) > 1)
+                        sizes.push_back(std::atoi(size.c_str()));
+                }
+                break;
+            default:
+                usage(argv[0]);
+                return 1;
+        }
+    }
+
+    if (optind + 1 != argc || sizes.empty()) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    // start from the wisdom the plugins would load, so that writing the
+    // result to the system wisdom keeps the plans of other programs
+    aubio_fft_load_wisdom(nullptr);
+    aubio_fft_set_measure(1);
+
+    for (uint_t size : sizes) {
+        std::printf("planning %u\n", size);
+        std::fflush(stdout);
+        aubio_fft_t* fft = new_aubio_fft(size);
+        if (fft == nullptr)
+            return 1;
+        del_aubio_fft(fft);
+    }
+
+    return aubio_fft_save_wisdom(argv[optind]) == 0 ? 0 : 1;
+}